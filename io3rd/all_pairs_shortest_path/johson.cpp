@@ -2,6 +2,12 @@
 #include <vector>
 #include <algorithm>
 #include <queue>
+#include <limits>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -18,7 +24,7 @@ struct TGraphGeneric {
     };
     using TAdjacencyList = std::vector<TVertextPath>;
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
         TAdjacencyList Adj;
     };
 
@@ -72,6 +78,7 @@ void init_single_source(const TGraph& graph, TGraph::TVertextId start, TAttrList
     for (auto& a : attr) {
         a.parent = attr.size();
         a.distance = INF_WEIGHT;
+        a.visited = false;
     }
     attr[start].distance = 0;
 }
@@ -112,27 +119,39 @@ bool bellman_ford(const TGraph& graph, TGraph::TVertextId start, TAttrList& attr
     return true;
 }
 
-void dijkstra(const TGraph& graph, TGraph::TVertextId start, TAttrList& attr) {
+// Heap storage is passed in, so repeated runs reuse its capacity
+void dijkstra(const TGraph& graph, TGraph::TVertextId start, TAttrList& attr, std::vector<TVertexInfo>& heap) {
     init_single_source(graph, start, attr);
 
-    std::priority_queue<TVertexInfo> pq;
-    pq.push(TVertexInfo{.vertex = start, .weight = 0});
+    heap.clear();
+    heap.push_back(TVertexInfo{.vertex = start, .weight = 0});
 
-    while(!pq.empty()) {
-        auto v = pq.top().vertex;
-        pq.pop();
+    while(!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        auto v = heap.back().vertex;
+        heap.pop_back();
+        if (attr[v].visited) {
+            // stale entry, vertex was settled with a smaller weight
+            continue;
+        }
         attr[v].visited = true;
         for (const auto& adj : graph.Vertices[v].Adj) { 
             relax(attr, graph.Edges[adj.edge]);
         }
         for (const auto& adj : graph.Vertices[v].Adj) {
             if (!attr[adj.vertex].visited) {
-                pq.push(TVertexInfo{.vertex = adj.vertex, .weight = attr[adj.vertex].distance});
+                heap.push_back(TVertexInfo{.vertex = adj.vertex, .weight = attr[adj.vertex].distance});
+                std::push_heap(heap.begin(), heap.end());
             }
         }
     }
 }
 
+void dijkstra(const TGraph& graph, TGraph::TVertextId start, TAttrList& attr) {
+    std::vector<TVertexInfo> heap;
+    dijkstra(graph, start, attr, heap);
+}
+
 using TAdjacencyMatrixRow = std::vector<int/*weight*/>;
 using TAdjacencyMatrix = std::vector<TAdjacencyMatrixRow>;
 
@@ -146,8 +165,10 @@ static void init_adj(TAdjacencyMatrix& adj, std::size_t n) {
     }
 }
 
-TAdjacencyMatrix johnson(const TGraph& input) {
-    TGraph graph = input;
+// Builds graph with transitive start vertex s0 and re-weights it to non negative weights.
+// Returns false if input contains negative weight cycles.
+bool johnson_reweight(const TGraph& input, TGraph& graph, TAttrList& heights) {
+    graph = input;
     // Add transitive start vertex
     TGraph::TVertextId s0 = graph.AddVertex("s0");
     for (TGraph::TVertextId v = 0; v < s0; ++v) {
@@ -155,10 +176,9 @@ TAdjacencyMatrix johnson(const TGraph& input) {
         graph.AddEdge(s0, v, 0);
     }
 
-    TAttrList heights;
     if (!bellman_ford(graph, s0, heights)) {
         // Graph contains negative weight cycles
-        return {};
+        return false;
     }
     // re-weight graph with height functions: w'(u,v) = w(u,v) + h(u) - h(v).
     // By triangle enequality h(v) <= h(u) + w(u,v), so w'(u,v) defined above is >=0.
@@ -166,6 +186,15 @@ TAdjacencyMatrix johnson(const TGraph& input) {
     for (auto& e : graph.Edges) {
         e.weight = e.weight + heights[e.v1].distance - heights[e.v2].distance;
     }
+    return true;
+}
+
+TAdjacencyMatrix johnson(const TGraph& input) {
+    TGraph graph;
+    TAttrList heights;
+    if (!johnson_reweight(input, graph, heights)) {
+        return {};
+    }
 
     TAdjacencyMatrix result;
     init_adj(result, input.Vertices.size());
@@ -183,7 +212,131 @@ TAdjacencyMatrix johnson(const TGraph& input) {
 }
 
 
-int main() {
+// Flat row-major n x n distances, row v1 holds distances from v1
+struct TDistanceMatrix {
+    std::size_t Size = 0;
+    std::vector<int> Data;
+
+    int* Row(std::size_t v) {
+        return Data.data() + v * Size;
+    }
+
+    const int* Row(std::size_t v) const {
+        return Data.data() + v * Size;
+    }
+};
+
+// Same as johnson, but per-source Dijkstra runs are spread over a pool of threads.
+// Every worker owns its heap and attribute scratch, so nothing is allocated per source,
+// and writes its rows straight into the shared flat result (rows never overlap).
+bool johnson_parallel(const TGraph& input, TDistanceMatrix& result, std::size_t threads_count = std::thread::hardware_concurrency()) {
+    TGraph graph;
+    TAttrList heights;
+    if (!johnson_reweight(input, graph, heights)) {
+        return false;
+    }
+
+    const std::size_t n = input.Vertices.size();
+    result.Size = n;
+    result.Data.resize(n * n);
+
+    // Sources are handed out in small batches to keep the shared counter cold
+    constexpr std::size_t BATCH = 16;
+    std::atomic_size_t next = 0;
+    auto worker = [&]() {
+        TAttrList weights;
+        std::vector<TVertexInfo> heap;
+        heap.reserve(graph.Edges.size());
+        for (std::size_t first = next.fetch_add(BATCH); first < n; first = next.fetch_add(BATCH)) {
+            for (TGraph::TVertextId v1 = first; v1 < std::min(first + BATCH, n); ++v1) {
+                dijkstra(graph, v1, weights, heap);
+                int* row = result.Row(v1);
+                for (TGraph::TVertextId v2 = 0; v2 < n; ++v2) {
+                    row[v2] = weights[v2].distance + heights[v2].distance - heights[v1].distance;
+                }
+            }
+        }
+    };
+
+    threads_count = std::max<std::size_t>(1, threads_count);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads_count; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    return true;
+}
+
+// Random graph with negative edges but without negative cycles:
+// w(u,v) = positive + p(u) - p(v) for some random potential p.
+TGraph make_random_graph(std::size_t vertexes_count, std::size_t out_degree, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> vertex(0, vertexes_count - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::uniform_int_distribution<int> potential(0, 50);
+    TGraph graph;
+    std::vector<int> p(vertexes_count);
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        graph.AddVertex(std::to_string(v));
+        p[v] = potential(rng);
+    }
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        for (std::size_t e = 0; e < out_degree; ++e) {
+            auto to = vertex(rng);
+            graph.AddEdge(v, to, weight(rng) + p[v] - p[to]);
+        }
+    }
+    return graph;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out 4096 16384
+void benchmark_johnson(const std::vector<std::size_t>& sizes) {
+    for (auto n : sizes) {
+        auto graph = make_random_graph(n, 8, 42);
+        TAdjacencyMatrix expected;
+        double sequential = measure_seconds([&] { expected = johnson(graph); });
+        std::cout << "johnson n=" << n << " sequential:" << sequential << "s" << std::endl;
+        std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> threads_counts;
+        for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+            threads_counts.push_back(threads);
+        }
+        threads_counts.push_back(max_threads);
+        for (auto threads : threads_counts) {
+            TDistanceMatrix actual;
+            double parallel = measure_seconds([&] { johnson_parallel(graph, actual, threads); });
+            bool same = true;
+            for (std::size_t v = 0; v < n; ++v) {
+                same = same && std::equal(expected[v].begin(), expected[v].end(), actual.Row(v));
+            }
+            std::cout << "    threads:" << threads << " parallel:" << parallel << "s"
+                << " speedup:" << sequential / parallel
+                << (same ? "" : " MISMATCH") << std::endl;
+        }
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        std::vector<std::size_t> sizes;
+        for (int i = 1; i < argc; ++i) {
+            sizes.push_back(std::stoul(argv[i]));
+        }
+        benchmark_johnson(sizes);
+        return 0;
+    }
+
     TGraph graph;    
     auto v1 = graph.AddVertex("1");
     auto v2 = graph.AddVertex("2");
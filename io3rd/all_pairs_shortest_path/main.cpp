@@ -4,6 +4,16 @@
 #include <vector>
 #include <algorithm>
 #include <queue>
+#include <limits>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
 
 constexpr int INF_WEIGHT = std::numeric_limits<int>::max() / 2;
 
@@ -19,7 +29,7 @@ struct TGraphGeneric {
     using TAdjacencyMatrix = std::vector<TAdjacencyMatrixRow>;
 
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
     };
 
     using TVertices = std::vector<TVertex>;
@@ -64,6 +74,181 @@ private:
 
 using TGraph = TGraphGeneric<true>;
 
+// Flat, row-major distance matrix. Rows are padded to a multiple of the tile size,
+// padded vertices are isolated (INF everywhere except 0 on the diagonal), so they never
+// shorten a real path.
+struct TFlatMatrix {
+    std::size_t Size = 0;
+    std::size_t Stride = 0;
+    std::vector<int> Data;
+
+    void Init(std::size_t n, std::size_t align) {
+        Size = n;
+        Stride = (n + align - 1) / align * align;
+        Data.assign(Stride * Stride, INF_WEIGHT);
+        for (std::size_t i = 0; i < Stride; ++i) {
+            Data[i * Stride + i] = 0;
+        }
+    }
+
+    int* Row(std::size_t i) {
+        return Data.data() + i * Stride;
+    }
+
+    const int* Row(std::size_t i) const {
+        return Data.data() + i * Stride;
+    }
+};
+
+// Tile edge in elements. One tile row is 256 bytes (4 zmm / 8 ymm registers),
+// three tiles (48K) stay close to L1/L2.
+constexpr std::size_t TILE = 64;
+
+TFlatMatrix to_flat(const TGraph::TAdjacencyMatrix& adj) {
+    TFlatMatrix result;
+    result.Init(adj.size(), TILE);
+    for (std::size_t i = 0; i < adj.size(); ++i) {
+        std::copy(adj[i].begin(), adj[i].end(), result.Row(i));
+    }
+    return result;
+}
+
+TGraph::TAdjacencyMatrix to_nested(const TFlatMatrix& flat) {
+    TGraph::TAdjacencyMatrix result(flat.Size);
+    for (std::size_t i = 0; i < flat.Size; ++i) {
+        result[i].assign(flat.Row(i), flat.Row(i) + flat.Size);
+    }
+    return result;
+}
+
+// Runs func(0..count-1) on all hardware threads, work is handed out by an atomic counter.
+template<typename TFunc>
+void parallel_for(std::size_t count, TFunc&& func) {
+    std::size_t threads_count = std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+    if (threads_count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+    std::atomic_size_t next = 0;
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            func(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < threads_count; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// Min-plus lanes: c = min(c, a + b). Widest ISA available at compile time (-march=native),
+// plain int otherwise (the compiler is still free to auto-vectorize it).
+struct TSimd {
+#if defined(__AVX512F__)
+    using TReg = __m512i;
+    static constexpr std::size_t Lanes = 16;
+    static TReg Load(const int* p) { return _mm512_loadu_si512(p); }
+    static void Store(int* p, TReg v) { _mm512_storeu_si512(p, v); }
+    static TReg Set1(int v) { return _mm512_set1_epi32(v); }
+    static TReg MinPlus(TReg c, TReg a, TReg b) { return _mm512_min_epi32(c, _mm512_add_epi32(a, b)); }
+#elif defined(__AVX2__)
+    using TReg = __m256i;
+    static constexpr std::size_t Lanes = 8;
+    static TReg Load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void Store(int* p, TReg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static TReg Set1(int v) { return _mm256_set1_epi32(v); }
+    static TReg MinPlus(TReg c, TReg a, TReg b) { return _mm256_min_epi32(c, _mm256_add_epi32(a, b)); }
+#else
+    using TReg = int;
+    static constexpr std::size_t Lanes = 1;
+    static TReg Load(const int* p) { return *p; }
+    static void Store(int* p, TReg v) { *p = v; }
+    static TReg Set1(int v) { return v; }
+    static TReg MinPlus(TReg c, TReg a, TReg b) { return std::min(c, a + b); }
+#endif
+};
+
+static_assert(TILE % TSimd::Lanes == 0);
+
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) with k as the outer loop, so the tiles
+// are allowed to alias (diagonal and row/column phases of Floyd-Warshall).
+void min_plus_tile_inplace(int* c, const int* a, const int* b, std::size_t stride) {
+    for (std::size_t k = 0; k < TILE; ++k) {
+        const int* bk = b + k * stride;
+        for (std::size_t i = 0; i < TILE; ++i) {
+            int* ci = c + i * stride;
+            auto aik = TSimd::Set1(a[i * stride + k]);
+            for (std::size_t j = 0; j < TILE; j += TSimd::Lanes) {
+                TSimd::Store(ci + j, TSimd::MinPlus(TSimd::Load(ci + j), aik, TSimd::Load(bk + j)));
+            }
+        }
+    }
+}
+
+// Same product for independent tiles. A strip of MR rows of c lives in registers
+// while k runs (MR*TILE/Lanes accumulators, 16 of them), b tile is streamed from L1.
+constexpr std::size_t MR = std::max<std::size_t>(1, 16 / (TILE / TSimd::Lanes));
+static_assert(TILE % MR == 0);
+
+void min_plus_tile(int* c, const int* a, const int* b, std::size_t stride) {
+    constexpr std::size_t REGS = TILE / TSimd::Lanes;
+    for (std::size_t i = 0; i < TILE; i += MR) {
+        TSimd::TReg acc[MR][REGS];
+        for (std::size_t m = 0; m < MR; ++m) {
+            for (std::size_t r = 0; r < REGS; ++r) {
+                acc[m][r] = TSimd::Load(c + (i + m) * stride + r * TSimd::Lanes);
+            }
+        }
+        for (std::size_t k = 0; k < TILE; ++k) {
+            const int* bk = b + k * stride;
+            for (std::size_t m = 0; m < MR; ++m) {
+                auto aik = TSimd::Set1(a[(i + m) * stride + k]);
+                for (std::size_t r = 0; r < REGS; ++r) {
+                    acc[m][r] = TSimd::MinPlus(acc[m][r], aik, TSimd::Load(bk + r * TSimd::Lanes));
+                }
+            }
+        }
+        for (std::size_t m = 0; m < MR; ++m) {
+            for (std::size_t r = 0; r < REGS; ++r) {
+                TSimd::Store(c + (i + m) * stride + r * TSimd::Lanes, acc[m][r]);
+            }
+        }
+    }
+}
+
+// Min-plus matrix product result = left (x) right. Result is a preallocated buffer of the
+// same shape, it gets INF with 0 on the diagonal first (same as init_adj), so the product
+// never shortens a path below "stay in place". Tiles of the result are independent
+// and are computed in parallel.
+void min_plus_product(const TFlatMatrix& left, const TFlatMatrix& right, TFlatMatrix& result) {
+    const std::size_t stride = result.Stride;
+    const std::size_t tiles = stride / TILE;
+    parallel_for(tiles * tiles, [&](std::size_t n) {
+        std::size_t ti = n / tiles;
+        std::size_t tj = n % tiles;
+        int* c = result.Data.data() + ti * TILE * stride + tj * TILE;
+        for (std::size_t i = 0; i < TILE; ++i) {
+            std::fill(c + i * stride, c + i * stride + TILE, INF_WEIGHT);
+            if (ti == tj) {
+                c[i * stride + i] = 0;
+            }
+        }
+        for (std::size_t kb = 0; kb < tiles; ++kb) {
+            min_plus_tile(c,
+                left.Data.data() + ti * TILE * stride + kb * TILE,
+                right.Data.data() + kb * TILE * stride + tj * TILE,
+                stride);
+        }
+    });
+}
+
+
 TGraph::TAdjacencyMatrix extend_shortest_path(const TGraph::TAdjacencyMatrix& curret_paths, const TGraph::TAdjacencyMatrix& adj) {
     const std::size_t vertexes_count = curret_paths.size();
     TGraph::TAdjacencyMatrix results;
@@ -79,22 +264,30 @@ TGraph::TAdjacencyMatrix extend_shortest_path(const TGraph::TAdjacencyMatrix& cu
 }
 
 TGraph::TAdjacencyMatrix slow_all_pairs_shortest_path(const TGraph& graph) {
-    auto paths = graph.Adj;
+    auto adj = to_flat(graph.Adj);
+    auto paths = adj;
+    TFlatMatrix next;
+    next.Init(paths.Size, TILE);
     for (int i = 1; i < graph.Vertices.size(); ++i) {
-        paths = extend_shortest_path(paths, graph.Adj);
+        min_plus_product(paths, adj, next);
+        std::swap(paths, next);
     }
-    return paths;
+    return to_nested(paths);
 }
 
 TGraph::TAdjacencyMatrix faster_all_pairs_shortest_path(const TGraph& graph) {
     std::size_t n = graph.Vertices.size();
     std::size_t m = 1;
-    auto paths = graph.Adj;
+    // Ping-pong between two preallocated buffers, no allocation per squaring step
+    auto paths = to_flat(graph.Adj);
+    TFlatMatrix next;
+    next.Init(n, TILE);
     while (m < n-1) {
-        paths = extend_shortest_path(paths, paths);
+        min_plus_product(paths, paths, next);
+        std::swap(paths, next);
         m = 2*m;
     }
-    return paths;
+    return to_nested(paths);
 }
 
 TGraph::TAdjacencyMatrix floyd_warshall(const TGraph& graph) {
@@ -111,11 +304,130 @@ TGraph::TAdjacencyMatrix floyd_warshall(const TGraph& graph) {
         }
 
     }
-    return prev;
+    return current;
+}
+
+
+// Blocked Floyd-Warshall. For every diagonal tile kb:
+//   1. close the diagonal tile (kb, kb) on itself,
+//   2. update row tiles (kb, j) and column tiles (i, kb) through the diagonal tile,
+//   3. update every other tile (i, j) with column tile (i, kb) x row tile (kb, j).
+// Tiles inside phases 2 and 3 do not depend on each other and run in parallel.
+void floyd_warshall_blocked(TFlatMatrix& dist) {
+    const std::size_t stride = dist.Stride;
+    const std::size_t tiles = stride / TILE;
+    auto tile = [&](std::size_t ti, std::size_t tj) {
+        return dist.Data.data() + ti * TILE * stride + tj * TILE;
+    };
+    for (std::size_t kb = 0; kb < tiles; ++kb) {
+        int* diagonal = tile(kb, kb);
+        min_plus_tile_inplace(diagonal, diagonal, diagonal, stride);
+
+        if (tiles > 1) {
+            parallel_for(2 * (tiles - 1), [&](std::size_t n) {
+                std::size_t other = n / 2;
+                other += other >= kb ? 1 : 0;
+                if (n % 2 == 0) {
+                    int* row = tile(kb, other);
+                    min_plus_tile_inplace(row, diagonal, row, stride);
+                } else {
+                    int* column = tile(other, kb);
+                    min_plus_tile_inplace(column, column, diagonal, stride);
+                }
+            });
+        }
+
+        parallel_for(tiles * tiles, [&](std::size_t n) {
+            std::size_t ti = n / tiles;
+            std::size_t tj = n % tiles;
+            if (ti == kb || tj == kb) {
+                return;
+            }
+            min_plus_tile(tile(ti, tj), tile(ti, kb), tile(kb, tj), stride);
+        });
+    }
+}
+
+TGraph::TAdjacencyMatrix floyd_warshall_blocked(const TGraph& graph) {
+    auto dist = to_flat(graph.Adj);
+    floyd_warshall_blocked(dist);
+    return to_nested(dist);
+}
+
+TGraph make_random_graph(std::size_t vertexes_count, std::size_t out_degree, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> vertex(0, vertexes_count - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    TGraph graph;
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    TGraph::init_adj(graph.Adj, vertexes_count);
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        for (std::size_t e = 0; e < out_degree; ++e) {
+            auto to = vertex(rng);
+            if (to != v) {
+                graph.AddEdge(v, to, weight(rng));
+            }
+        }
+    }
+    return graph;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out 1024 4096 8192
+void benchmark_min_plus_product(const std::vector<std::size_t>& sizes) {
+    for (auto n : sizes) {
+        auto graph = make_random_graph(n, 8, 42);
+        auto left = to_flat(graph.Adj);
+        TFlatMatrix result;
+        result.Init(n, TILE);
+        TGraph::TAdjacencyMatrix expected;
+        double textbook = measure_seconds([&] { expected = extend_shortest_path(graph.Adj, graph.Adj); });
+        double blocked = measure_seconds([&] { min_plus_product(left, left, result); });
+        double squaring = measure_seconds([&] { faster_all_pairs_shortest_path(graph); });
+        std::cout << "min_plus_product n=" << n
+            << " textbook:" << textbook << "s"
+            << " blocked:" << blocked << "s"
+            << " speedup:" << textbook / blocked
+            << " faster_all_pairs_shortest_path:" << squaring << "s"
+            << (expected == to_nested(result) ? "" : " MISMATCH") << std::endl;
+    }
 }
 
+void benchmark_floyd_warshall(const std::vector<std::size_t>& sizes) {
+    for (auto n : sizes) {
+        auto graph = make_random_graph(n, 8, 42);
+        TGraph::TAdjacencyMatrix expected;
+        TGraph::TAdjacencyMatrix actual;
+        double textbook = measure_seconds([&] { expected = floyd_warshall(graph); });
+        double blocked = measure_seconds([&] { actual = floyd_warshall_blocked(graph); });
+        std::cout << "floyd_warshall n=" << n
+            << " textbook:" << textbook << "s"
+            << " blocked:" << blocked << "s"
+            << " speedup:" << textbook / blocked
+            << (expected == actual ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        std::vector<std::size_t> sizes;
+        for (int i = 1; i < argc; ++i) {
+            sizes.push_back(std::stoul(argv[i]));
+        }
+        benchmark_floyd_warshall(sizes);
+        benchmark_min_plus_product(sizes);
+        return 0;
+    }
 
-int main() {
     TGraph graph;    
     auto s = graph.AddVertex("s");
     auto t = graph.AddVertex("t");
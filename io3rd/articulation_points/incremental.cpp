@@ -0,0 +1,445 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+enum class ECompression {
+    Full,       // second pass points every node on the path to the root
+    Halving,    // every other node on the path points to its grandparent
+    Splitting,  // every node on the path points to its grandparent
+};
+
+// Index based union-find, 4 bytes per element: Parent[v] >= 0 is the parent of v,
+// negative value marks a root and holds minus size of its set (union by size).
+template<ECompression Compression = ECompression::Halving>
+struct TFlatDisjointSet {
+    using TId = std::uint32_t;
+
+    explicit TFlatDisjointSet(std::size_t size)
+        : Parent(size, -1)
+    {
+    }
+
+    TId FindSet(TId node) {
+        if constexpr (Compression == ECompression::Full) {
+            TId root = node;
+            while (Parent[root] >= 0) {
+                root = Parent[root];
+            }
+            while (node != root) {
+                TId next = Parent[node];
+                Parent[node] = root;
+                node = next;
+            }
+            return root;
+        } else {
+            while (Parent[node] >= 0) {
+                TId parent = Parent[node];
+                if (Parent[parent] < 0) {
+                    return parent;
+                }
+                Parent[node] = Parent[parent];
+                node = Compression == ECompression::Halving ? Parent[parent] : parent;
+            }
+            return node;
+        }
+    }
+
+    bool IsSameSet(TId x, TId y) {
+        return FindSet(x) == FindSet(y);
+    }
+
+    bool Union(TId x, TId y) {
+        x = FindSet(x);
+        y = FindSet(y);
+        if (x == y) {
+            return false;
+        }
+        // Attach smaller set to the bigger one, sizes are negative
+        if (Parent[x] > Parent[y]) {
+            std::swap(x, y);
+        }
+        Parent[x] += Parent[y];
+        Parent[y] = x;
+        return true;
+    }
+
+    std::size_t SetSize(TId node) {
+        return -Parent[FindSet(node)];
+    }
+
+private:
+    std::vector<std::int32_t> Parent;
+};
+
+// Connectivity under a stream of edge insertions: union-find, near constant time per operation
+struct TIncrementalConnectivity {
+    using TVertextId = std::uint32_t;
+
+    explicit TIncrementalConnectivity(std::size_t size)
+        : DisjointSet(size)
+        , ComponentsCount(size)
+    {
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2) {
+        ComponentsCount -= DisjointSet.Union(v1, v2);
+    }
+
+    bool Connected(TVertextId v1, TVertextId v2) {
+        return DisjointSet.IsSameSet(v1, v2);
+    }
+
+    TFlatDisjointSet<> DisjointSet;
+    std::size_t ComponentsCount;
+};
+
+// Online bridges / 2-edge-connectivity under edge insertions.
+// 2-edge-connected components are contracted by one union-find, they form a forest of bridges
+// stored as parent links (Parent) between component representatives, and connected components
+// of that forest are tracked by another union-find (with sizes).
+//   - edge inside a 2-edge-connected component: nothing changes;
+//   - edge between two trees: new bridge, the smaller tree is re-rooted and hung under the other;
+//   - edge inside a tree: every bridge on the tree path becomes a cycle, path is merged into
+//     one 2-edge-connected component.
+// Re-rooting the smaller tree gives O(n log n) total, plus near constant union-find work per edge.
+struct TIncrementalBridges {
+    using TVertextId = std::uint32_t;
+    static constexpr TVertextId NIL = std::numeric_limits<TVertextId>::max();
+
+    explicit TIncrementalBridges(std::size_t size)
+        : Parent(size, NIL)
+        , TwoEdge(size)
+        , Connected(size)
+        , ConnectedSize(size, 1)
+        , LastVisit(size, 0)
+    {
+        for (TVertextId v = 0; v < size; ++v) {
+            TwoEdge[v] = v;
+            Connected[v] = v;
+        }
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2) {
+        v1 = FindTwoEdge(v1);
+        v2 = FindTwoEdge(v2);
+        if (v1 == v2) {
+            return;
+        }
+        TVertextId c1 = FindConnected(v1);
+        TVertextId c2 = FindConnected(v2);
+        if (c1 != c2) {
+            ++BridgesCount;
+            if (ConnectedSize[c1] > ConnectedSize[c2]) {
+                std::swap(v1, v2);
+                std::swap(c1, c2);
+            }
+            MakeRoot(v1);
+            Parent[v1] = v2;
+            Connected[v1] = v2;
+            ConnectedSize[c2] += ConnectedSize[v1];
+        } else {
+            MergePath(v1, v2);
+        }
+    }
+
+    bool IsConnected(TVertextId v1, TVertextId v2) {
+        return FindConnected(v1) == FindConnected(v2);
+    }
+
+    bool IsTwoEdgeConnected(TVertextId v1, TVertextId v2) {
+        return FindTwoEdge(v1) == FindTwoEdge(v2);
+    }
+
+    std::size_t Bridges() const {
+        return BridgesCount;
+    }
+
+private:
+    TVertextId FindTwoEdge(TVertextId v) {
+        if (v == NIL) {
+            return NIL;
+        }
+        TVertextId root = v;
+        while (TwoEdge[root] != root) {
+            root = TwoEdge[root];
+        }
+        while (TwoEdge[v] != root) {
+            TVertextId next = TwoEdge[v];
+            TwoEdge[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    TVertextId FindConnected(TVertextId v) {
+        v = FindTwoEdge(v);
+        TVertextId root = v;
+        while (Connected[root] != root) {
+            root = Connected[root];
+        }
+        while (Connected[v] != root) {
+            TVertextId next = Connected[v];
+            Connected[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    // Reverses parent links on the path from v to its tree root, v becomes the root
+    void MakeRoot(TVertextId v) {
+        const TVertextId root = v;
+        TVertextId child = NIL;
+        while (v != NIL) {
+            TVertextId parent = FindTwoEdge(Parent[v]);
+            Parent[v] = child;
+            Connected[v] = root;
+            child = v;
+            v = parent;
+        }
+        ConnectedSize[root] = ConnectedSize[child];
+    }
+
+    // Walks up from both ends in turns until the paths meet, then contracts both paths
+    void MergePath(TVertextId v1, TVertextId v2) {
+        ++Iteration;
+        PathA.clear();
+        PathB.clear();
+        TVertextId lca = NIL;
+        auto step = [&](TVertextId& v, std::vector<TVertextId>& path) {
+            if (v == NIL) {
+                return false;
+            }
+            v = FindTwoEdge(v);
+            path.push_back(v);
+            if (LastVisit[v] == Iteration) {
+                lca = v;
+                return true;
+            }
+            LastVisit[v] = Iteration;
+            v = Parent[v];
+            return false;
+        };
+        while (!step(v1, PathA) && !step(v2, PathB)) {
+        }
+        for (auto* path : {&PathA, &PathB}) {
+            for (auto v : *path) {
+                TwoEdge[v] = lca;
+                if (v == lca) {
+                    break;
+                }
+                --BridgesCount;
+            }
+        }
+    }
+
+    std::vector<TVertextId> Parent;
+    std::vector<TVertextId> TwoEdge;
+    std::vector<TVertextId> Connected;
+    std::vector<std::uint32_t> ConnectedSize;
+    std::vector<std::uint32_t> LastVisit;
+    std::uint32_t Iteration = 0;
+    std::vector<TVertextId> PathA;
+    std::vector<TVertextId> PathB;
+    std::size_t BridgesCount = 0;
+};
+
+struct TOperation {
+    bool Query = false;
+    std::uint32_t v1 = 0;
+    std::uint32_t v2 = 0;
+};
+
+// Insertions with a query after every insertion
+std::vector<TOperation> make_log(std::size_t vertexes_count, std::size_t edges_count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, vertexes_count - 1);
+    std::vector<TOperation> log;
+    log.reserve(2 * edges_count);
+    for (std::size_t e = 0; e < edges_count; ++e) {
+        log.push_back(TOperation{.Query = false, .v1 = vertex(rng), .v2 = vertex(rng)});
+        log.push_back(TOperation{.Query = true, .v1 = vertex(rng), .v2 = vertex(rng)});
+    }
+    return log;
+}
+
+// What the bridge tracker knows after an insertion, for one query pair
+struct TAnswer {
+    bool Connected = false;
+    bool TwoEdgeConnected = false;
+    std::size_t Bridges = 0;
+
+    friend bool operator==(const TAnswer&, const TAnswer&) = default;
+};
+
+// Baseline: every query is answered from scratch over the edges inserted so far. A static
+// lowlink DFS (parent edge skipped by id, so parallel edges are not bridges) counts bridges
+// and labels connected components, then a BFS over non bridge edges answers 2-edge-connectivity.
+// Only vertices touched by some edge are scanned, the rest are isolated.
+std::vector<TAnswer> replay_recompute(std::size_t vertexes_count, const std::vector<TOperation>& log) {
+    constexpr std::uint32_t NO_EDGE = std::numeric_limits<std::uint32_t>::max();
+    struct TArc {
+        std::uint32_t to;
+        std::uint32_t edge;
+    };
+    struct TFrame {
+        std::uint32_t vertex;
+        std::uint32_t parent_edge;
+        std::uint32_t next;
+    };
+    std::vector<std::vector<TArc>> adj(vertexes_count);
+    std::vector<std::uint32_t> touched;
+    std::vector<std::uint32_t> discovery(vertexes_count, 0);
+    std::vector<std::uint32_t> low(vertexes_count, 0);
+    std::vector<std::uint32_t> tree(vertexes_count, 0);
+    std::vector<std::uint32_t> seen(vertexes_count, 0);
+    std::vector<bool> bridge;
+    std::vector<TFrame> stack;
+    std::deque<std::uint32_t> queue;
+    std::uint32_t edges = 0;
+    std::uint32_t stamp = 0;
+    std::vector<TAnswer> answers;
+    for (const auto& op : log) {
+        if (!op.Query) {
+            if (adj[op.v1].empty()) {
+                touched.push_back(op.v1);
+            }
+            adj[op.v1].push_back(TArc{.to = op.v2, .edge = edges});
+            if (adj[op.v2].empty()) {
+                touched.push_back(op.v2);
+            }
+            adj[op.v2].push_back(TArc{.to = op.v1, .edge = edges});
+            ++edges;
+            continue;
+        }
+
+        TAnswer answer;
+        bridge.assign(edges, false);
+        for (auto v : touched) {
+            discovery[v] = 0;
+        }
+        std::uint32_t ticker = 0;
+        for (auto root : touched) {
+            if (discovery[root] != 0) {
+                continue;
+            }
+            discovery[root] = low[root] = ++ticker;
+            tree[root] = root;
+            stack.push_back(TFrame{.vertex = root, .parent_edge = NO_EDGE, .next = 0});
+            while (!stack.empty()) {
+                auto& frame = stack.back();
+                const auto v = frame.vertex;
+                if (frame.next < adj[v].size()) {
+                    const auto arc = adj[v][frame.next++];
+                    if (arc.edge == frame.parent_edge) {
+                        continue;
+                    }
+                    if (discovery[arc.to] == 0) {
+                        discovery[arc.to] = low[arc.to] = ++ticker;
+                        tree[arc.to] = root;
+                        stack.push_back(TFrame{.vertex = arc.to, .parent_edge = arc.edge, .next = 0});
+                    } else {
+                        low[v] = std::min(low[v], discovery[arc.to]);
+                    }
+                    continue;
+                }
+                const auto parent_edge = frame.parent_edge;
+                stack.pop_back();
+                if (!stack.empty()) {
+                    const auto u = stack.back().vertex;
+                    low[u] = std::min(low[u], low[v]);
+                    if (low[v] > discovery[u]) {
+                        bridge[parent_edge] = true;
+                        ++answer.Bridges;
+                    }
+                }
+            }
+        }
+
+        answer.Connected = op.v1 == op.v2
+            || (discovery[op.v1] != 0 && discovery[op.v2] != 0 && tree[op.v1] == tree[op.v2]);
+        answer.TwoEdgeConnected = op.v1 == op.v2;
+        if (answer.Connected && !answer.TwoEdgeConnected) {
+            ++stamp;
+            queue.assign(1, op.v1);
+            seen[op.v1] = stamp;
+            while (!queue.empty() && !answer.TwoEdgeConnected) {
+                auto v = queue.front();
+                queue.pop_front();
+                for (const auto& arc : adj[v]) {
+                    if (!bridge[arc.edge] && seen[arc.to] != stamp) {
+                        seen[arc.to] = stamp;
+                        answer.TwoEdgeConnected = answer.TwoEdgeConnected || arc.to == op.v2;
+                        queue.push_back(arc.to);
+                    }
+                }
+            }
+        }
+        answers.push_back(answer);
+    }
+    return answers;
+}
+
+template<typename TStructure, typename TQuery>
+auto replay(TStructure& structure, const std::vector<TOperation>& log, TQuery&& query) {
+    std::vector<decltype(query(structure, log[0].v1, log[0].v2))> answers;
+    for (const auto& op : log) {
+        if (op.Query) {
+            answers.push_back(query(structure, op.v1, op.v2));
+        } else {
+            structure.AddEdge(op.v1, op.v2);
+        }
+    }
+    return answers;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges> <edges replayed by the recompute baseline>
+int main(int argc, char* argv[]) {
+    std::size_t vertexes_count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    std::size_t edges_count = argc > 2 ? std::stoul(argv[2]) : 1'000'000;
+    std::size_t baseline_edges = argc > 3 ? std::stoul(argv[3]) : 2'000;
+    auto log = make_log(vertexes_count, edges_count, 42);
+
+    std::vector<bool> connectivity_answers;
+    double connectivity = measure_seconds([&] {
+        TIncrementalConnectivity structure(vertexes_count);
+        connectivity_answers = replay(structure, log, [](auto& s, auto v1, auto v2) { return s.Connected(v1, v2); });
+    });
+
+    std::vector<TAnswer> bridges_answers;
+    std::size_t bridges = 0;
+    double bridges_time = measure_seconds([&] {
+        TIncrementalBridges structure(vertexes_count);
+        bridges_answers = replay(structure, log, [](auto& s, auto v1, auto v2) {
+            return TAnswer{.Connected = s.IsConnected(v1, v2), .TwoEdgeConnected = s.IsTwoEdgeConnected(v1, v2), .Bridges = s.Bridges()};
+        });
+        bridges = structure.Bridges();
+    });
+
+    std::vector<TOperation> prefix(log.begin(), log.begin() + std::min(log.size(), 2 * baseline_edges));
+    std::vector<TAnswer> baseline_answers;
+    double baseline = measure_seconds([&] { baseline_answers = replay_recompute(vertexes_count, prefix); });
+    bool same = std::equal(baseline_answers.begin(), baseline_answers.end(), bridges_answers.begin());
+    for (std::size_t i = 0; i < connectivity_answers.size(); ++i) {
+        same = same && connectivity_answers[i] == bridges_answers[i].Connected;
+    }
+
+    std::cout << "operations:" << log.size() << std::endl
+        << "    union-find connectivity: " << connectivity << "s ops/s:" << log.size() / connectivity << std::endl
+        << "    bridge tracker: " << bridges_time << "s ops/s:" << log.size() / bridges_time
+        << " bridges at the end:" << bridges << std::endl
+        << "    recompute bridges per query (" << prefix.size() << " operations): " << baseline << "s ops/s:" << prefix.size() / baseline
+        << (same ? "" : " MISMATCH") << std::endl;
+    return 0;
+}
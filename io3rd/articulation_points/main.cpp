@@ -9,7 +9,13 @@
 #include <climits>
 #include <set>
 #include <algorithm>
+#include <numeric>
+#include <limits>
 #include <sstream>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <sys/resource.h>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -296,6 +302,111 @@ std::vector<TGraph::TEdge> get_bridges(const TGraph& g, const TDFSContext& ctx)
     }
     return results;
 }
+
+struct TBiconnectedComponents {
+    std::vector<TGraph::TVertextId> ArticulationPoints;
+    std::vector<TGraph::TEdgeId> Bridges;
+    // Edges of component c are ComponentEdges[ComponentOffsets[c] .. ComponentOffsets[c + 1])
+    std::vector<TGraph::TEdgeId> ComponentEdges;
+    std::vector<std::size_t> ComponentOffsets{0};
+
+    std::size_t ComponentsCount() const {
+        return ComponentOffsets.size() - 1;
+    }
+};
+
+// Single pass iterative Hopcroft-Tarjan. Low links are computed on the fly while the DFS
+// unwinds, in flat arrays (discovery, low, DFS stack, edge stack), no predecessor tree.
+// Parent edge is skipped by edge id, so parallel edges are handled right. A self loop lies on
+// no path between two vertices, the DFS skips it and it becomes a component of its own.
+TBiconnectedComponents biconnected_components(const TGraph& g) {
+    const std::size_t n = g.Vertices.size();
+    TBiconnectedComponents result;
+    std::vector<std::uint32_t> discovery(n, 0);
+    std::vector<std::uint32_t> low(n, 0);
+    std::vector<bool> articulation(n, false);
+    struct TFrame {
+        TGraph::TVertextId vertex;
+        TGraph::TEdgeId parent_edge;
+        std::size_t next;
+    };
+    std::vector<TFrame> stack;
+    std::vector<TGraph::TEdgeId> edges;
+    std::uint32_t ticker = 0;
+
+    for (TGraph::TVertextId root = 0; root < n; ++root) {
+        if (discovery[root] != 0) {
+            continue;
+        }
+        discovery[root] = low[root] = ++ticker;
+        stack.push_back(TFrame{.vertex = root, .parent_edge = TGraph::NIL_EDGE_ID, .next = 0});
+        std::size_t root_children = 0;
+        while (!stack.empty()) {
+            auto& frame = stack.back();
+            const auto v = frame.vertex;
+            const auto& adj = g.Vertices[v].Adj;
+            if (frame.next < adj.size()) {
+                const auto path = adj[frame.next++];
+                if (path.edge == frame.parent_edge) {
+                    continue;
+                }
+                const auto w = path.vertex;
+                if (discovery[w] == 0) {
+                    // tree edge
+                    edges.push_back(path.edge);
+                    discovery[w] = low[w] = ++ticker;
+                    root_children += v == root;
+                    stack.push_back(TFrame{.vertex = w, .parent_edge = path.edge, .next = 0});
+                } else if (discovery[w] < discovery[v]) {
+                    // back edge, seen first from the deeper end
+                    edges.push_back(path.edge);
+                    low[v] = std::min(low[v], discovery[w]);
+                }
+                continue;
+            }
+
+            const auto parent_edge = frame.parent_edge;
+            stack.pop_back();
+            if (stack.empty()) {
+                break;
+            }
+            const auto u = stack.back().vertex;
+            low[u] = std::min(low[u], low[v]);
+            if (low[v] >= discovery[u]) {
+                // u separates subtree of v: everything above the tree edge (u, v) is one component
+                if (u != root) {
+                    articulation[u] = true;
+                }
+                TGraph::TEdgeId e;
+                do {
+                    e = edges.back();
+                    edges.pop_back();
+                    result.ComponentEdges.push_back(e);
+                } while (e != parent_edge);
+                result.ComponentOffsets.push_back(result.ComponentEdges.size());
+                if (low[v] > discovery[u]) {
+                    result.Bridges.push_back(parent_edge);
+                }
+            }
+        }
+        if (root_children > 1) {
+            articulation[root] = true;
+        }
+    }
+    for (TGraph::TEdgeId e = 0; e < g.Edges.size(); ++e) {
+        if (g.Edges[e].v1 == g.Edges[e].v2) {
+            result.ComponentEdges.push_back(e);
+            result.ComponentOffsets.push_back(result.ComponentEdges.size());
+        }
+    }
+    for (TGraph::TVertextId v = 0; v < n; ++v) {
+        if (articulation[v]) {
+            result.ArticulationPoints.push_back(v);
+        }
+    }
+    return result;
+}
+
 using namespace std;
 
 bool is_conncted(int n, const vector<vector<int>>& connections) {
@@ -365,6 +476,21 @@ public:
     }
 };
 
+class Solution3 {
+public:
+    vector<vector<int>> criticalConnections(int n, const vector<vector<int>>& connections) {
+        TGraph g;
+        g.Vertices.resize(n);
+        for (const auto& e : connections) {
+            g.AddEdge(e.front(), e.back());
+        }
+        vector<vector<int>> results;
+        for (auto id : biconnected_components(g).Bridges) {
+            results.push_back({int(g.Edges[id].v1), int(g.Edges[id].v2)});
+        }
+        return results;
+    }
+};
 
 using connections_t = std::vector<std::vector<int>>;
 std::pair<int, connections_t> generate_random(int max_count) { 
@@ -406,7 +532,145 @@ std::string print(const connections_t& input) {
 } 
 
 
-int main() {    
+// Brute force reference for biconnected components: two edges are in one component iff no
+// vertex x separates them, i.e. their ends other than x stay connected in G - x.
+// A self loop is a component of its own.
+std::vector<std::vector<bool>> brute_force_same_component(const TGraph& g) {
+    const std::size_t n = g.Vertices.size();
+    const std::size_t m = g.Edges.size();
+    std::vector<std::vector<bool>> same(m, std::vector<bool>(m, true));
+    std::vector<std::size_t> root(n);
+    std::function<std::size_t(std::size_t)> find = [&](std::size_t v) {
+        return root[v] == v ? v : root[v] = find(root[v]);
+    };
+    for (TGraph::TVertextId x = 0; x < n; ++x) {
+        std::iota(root.begin(), root.end(), 0);
+        for (const auto& e : g.Edges) {
+            if (e.v1 != x && e.v2 != x) {
+                root[find(e.v1)] = find(e.v2);
+            }
+        }
+        auto end_of = [&](const TGraph::TEdge& e) {
+            return find(e.v1 == x ? e.v2 : e.v1);
+        };
+        for (std::size_t e = 0; e < m; ++e) {
+            for (std::size_t f = 0; f < m; ++f) {
+                const bool loop = g.Edges[e].v1 == g.Edges[e].v2 || g.Edges[f].v1 == g.Edges[f].v2;
+                if ((loop && e != f) || end_of(g.Edges[e]) != end_of(g.Edges[f])) {
+                    same[e][f] = false;
+                }
+            }
+        }
+    }
+    return same;
+}
+
+// Checks articulation points and components of the one pass version against the staged DFS
+// and the brute force reference, returns what differs
+std::string check_biconnected(int n, const connections_t& connections) {
+    TGraph g;
+    g.Vertices.resize(n);
+    for (const auto& e : connections) {
+        g.AddEdge(e.front(), e.back());
+    }
+    auto one_pass = biconnected_components(g);
+    std::ostringstream errors;
+
+    TDFSContext ctx{g};
+    DFS(g, ctx);
+    auto staged = get_articulation_points(g, ctx);
+    std::vector<TGraph::TVertextId> expected(staged.begin(), staged.end());
+    std::sort(expected.begin(), expected.end());
+    auto points = one_pass.ArticulationPoints;
+    std::sort(points.begin(), points.end());
+    if (points != expected) {
+        errors << "articulation points differ: " << points.size() << " vs " << expected.size() << " expected; ";
+    }
+
+    // Every edge is in exactly one component
+    constexpr std::size_t NO_COMPONENT = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> component(g.Edges.size(), NO_COMPONENT);
+    for (std::size_t c = 0; c < one_pass.ComponentsCount(); ++c) {
+        for (auto i = one_pass.ComponentOffsets[c]; i < one_pass.ComponentOffsets[c + 1]; ++i) {
+            auto e = one_pass.ComponentEdges[i];
+            if (component[e] != NO_COMPONENT) {
+                errors << "edge " << e << " is in components " << component[e] << " and " << c << "; ";
+            }
+            component[e] = c;
+        }
+    }
+    for (std::size_t e = 0; e < g.Edges.size(); ++e) {
+        if (component[e] == NO_COMPONENT) {
+            errors << "edge " << e << " is in no component; ";
+        }
+    }
+    auto same = brute_force_same_component(g);
+    for (std::size_t e = 0; e < g.Edges.size(); ++e) {
+        for (std::size_t f = e + 1; f < g.Edges.size(); ++f) {
+            if ((component[e] == component[f]) != same[e][f]) {
+                errors << "edges " << e << " and " << f << (same[e][f] ? " must" : " must not") << " share a component; ";
+            }
+        }
+    }
+    return errors.str();
+}
+
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges>
+// The staged version recurses over the predecessor tree, deep DFS trees need `ulimit -s unlimited`.
+// One pass version runs first, so the peak RSS growth of the staged one is on top of it.
+void benchmark_biconnected(std::size_t vertexes_count, std::size_t edges_count) {
+    std::mt19937_64 rng(42);
+    TGraph g;
+    g.Vertices.resize(vertexes_count);
+    for (std::size_t v = 1; v < vertexes_count; ++v) {
+        g.AddEdge(v, rng() % v);
+    }
+    while (g.Edges.size() < edges_count) {
+        g.AddEdge(rng() % vertexes_count, rng() % vertexes_count);
+    }
+
+    long rss = peak_rss_kb();
+    TBiconnectedComponents one_pass;
+    double one_pass_time = measure_seconds([&] { one_pass = biconnected_components(g); });
+    std::cout << "one pass: " << one_pass_time << "s"
+        << " peak rss growth:" << (peak_rss_kb() - rss) / 1024 << "MB"
+        << " articulation points:" << one_pass.ArticulationPoints.size()
+        << " bridges:" << one_pass.Bridges.size()
+        << " components:" << one_pass.ComponentsCount() << std::endl;
+
+    rss = peak_rss_kb();
+    vertex_list_t points;
+    std::vector<TGraph::TEdge> bridges;
+    double staged_time = measure_seconds([&] {
+        TDFSContext ctx{g};
+        DFS(g, ctx);
+        points = get_articulation_points(g, ctx);
+        bridges = get_bridges(g, ctx);
+    });
+    std::cout << "staged: " << staged_time << "s"
+        << " peak rss growth:" << (peak_rss_kb() - rss) / 1024 << "MB"
+        << " articulation points:" << points.size()
+        << " bridges:" << bridges.size() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        benchmark_biconnected(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
 
     for (int i = 0; i < 1000000; ++i) {
         const auto sample = generate_random(10);
@@ -415,8 +679,25 @@ int main() {
         }
         auto r1 = Solution1().criticalConnections(sample.first, sample.second);
         auto r2 = Solution2().criticalConnections(sample.first, sample.second);
+        auto r3 = Solution3().criticalConnections(sample.first, sample.second);
         canonical(r1);
         canonical(r2);
+        canonical(r3);
+        if (r2 != r3) {
+            std::cout << "one pass mismatch, graph: n=" << sample.first << " edges:" << print(sample.second) << std::endl
+                << "expected: " << print(r2) << std::endl
+                << "got: " << print(r3) << std::endl;
+        }
+        // Same graph with self loops, which the generator never makes
+        auto looped = sample.second;
+        looped.push_back({0, 0});
+        looped.push_back({sample.first - 1, sample.first - 1});
+        for (const auto& edges : {sample.second, looped}) {
+            if (auto errors = check_biconnected(sample.first, edges); !errors.empty()) {
+                std::cout << "one pass components mismatch, graph: n=" << sample.first << " edges:" << print(edges) << std::endl
+                    << errors << std::endl;
+            }
+        }
         if (r2.empty()) {
             continue;
         }
@@ -4,6 +4,14 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <deque>
+#include <string>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <chrono>
+#include <random>
 
 
 struct TGraph {
@@ -53,16 +61,12 @@ void BFS(const TGraph& g, TGraph::TVertextId startingPoint, TVisitor visitor) {
     std::deque<TGraph::TVertextId> queue;
     std::vector<TVertextRuntimeAttr> runtimeAttr(g.Vertices.size());
     runtimeAttr[startingPoint].Parent = startingPoint;
+    runtimeAttr[startingPoint].Seen = true;
     queue.push_back(startingPoint);
     while (!queue.empty()) {
         auto current = queue.front();
         queue.pop_front();
         auto& attr = runtimeAttr[current];
-        if (attr.Seen) {
-            // already visisted
-            continue;
-        }
-        attr.Seen = true;
         const auto& vertex = g.Vertices[current];
         if (!visitor(current, vertex.Value, attr.Parent, attr.Distance)) {
             // Interrapted by cliet code.
@@ -70,16 +74,171 @@ void BFS(const TGraph& g, TGraph::TVertextId startingPoint, TVisitor visitor) {
         }
 
         for (auto v : vertex.Adj) {
-            queue.push_back(v);
             auto& vattr = runtimeAttr[v];
+            // Marked on discovery: the first parent to reach v is on a shortest path,
+            // later ones must not overwrite its distance
+            if (vattr.Seen) {
+                continue;
+            }
+            vattr.Seen = true;
             vattr.Distance = attr.Distance + 1;
             vattr.Parent = current;
+            queue.push_back(v);
         }
     }
 }
 
+// Multi-source BFS (MS-BFS, Then et al.): up to 64 BFS runs at once, one bit per source in a
+// 64-bit word per vertex for seen, frontier and next frontier. Sources which reach a vertex at
+// the same level share one adjacency scan, so on small world graphs, where most BFS runs
+// overlap, the cost per source drops well below a separate BFS. Every level is two linear
+// passes over the words, vertices outside the frontier are skipped by a zero test.
+//
+// State is allocated once and reused by every Run.
+class TMultiSourceBfs {
+public:
+    static constexpr std::size_t BATCH = 64;
+
+    explicit TMultiSourceBfs(const TGraph& graph)
+        : Graph(graph)
+        , Seen(graph.Vertices.size(), 0)
+        , Frontier(graph.Vertices.size(), 0)
+        , Next(graph.Vertices.size(), 0)
+    {
+    }
+
+    // BFS from sources (at most BATCH), onVisit(vertex, bits, level) is called once per vertex
+    // and level with the bits of the sources reaching it at that distance
+    template<typename TOnVisit>
+    void Run(std::span<const TGraph::TVertextId> sources, TOnVisit&& onVisit) {
+        const std::size_t n = Graph.Vertices.size();
+        std::fill(Seen.begin(), Seen.end(), 0);
+        std::fill(Frontier.begin(), Frontier.end(), 0);
+        for (std::size_t i = 0; i < std::min(sources.size(), BATCH); ++i) {
+            const std::uint64_t bit = std::uint64_t(1) << i;
+            Seen[sources[i]] |= bit;
+            Frontier[sources[i]] |= bit;
+            onVisit(sources[i], bit, 0u);
+        }
+        bool any = true;
+        for (std::uint32_t level = 1; any; ++level) {
+            for (TGraph::TVertextId v = 0; v < n; ++v) {
+                if (const auto bits = Frontier[v]) {
+                    for (auto u : Graph.Vertices[v].Adj) {
+                        Next[u] |= bits;
+                    }
+                }
+            }
+            any = false;
+            for (TGraph::TVertextId v = 0; v < n; ++v) {
+                const auto bits = Next[v] & ~Seen[v];
+                Next[v] = 0;
+                Frontier[v] = bits;
+                if (bits) {
+                    Seen[v] |= bits;
+                    onVisit(v, bits, level);
+                    any = true;
+                }
+            }
+        }
+    }
+
+private:
+    const TGraph& Graph;
+    std::vector<std::uint64_t> Seen;
+    std::vector<std::uint64_t> Frontier;
+    std::vector<std::uint64_t> Next;
+};
+
+// Hop distances from every source, source major: Of(i)[v] is the distance from sources[i] to v
+struct TMultiSourceDistances {
+    static constexpr std::uint32_t UNREACHED = std::numeric_limits<std::uint32_t>::max();
+
+    std::size_t VerticesCount = 0;
+    std::vector<std::uint32_t> Data;
+
+    std::span<const std::uint32_t> Of(std::size_t source) const {
+        return {Data.data() + source * VerticesCount, VerticesCount};
+    }
+};
+
+// Any number of sources, in batches of 64
+TMultiSourceDistances MultiSourceDistances(const TGraph& graph, std::span<const TGraph::TVertextId> sources) {
+    const std::size_t n = graph.Vertices.size();
+    TMultiSourceDistances result;
+    result.VerticesCount = n;
+    result.Data.assign(sources.size() * n, TMultiSourceDistances::UNREACHED);
+    TMultiSourceBfs bfs(graph);
+    for (std::size_t first = 0; first < sources.size(); first += TMultiSourceBfs::BATCH) {
+        auto batch = sources.subspan(first, std::min(TMultiSourceBfs::BATCH, sources.size() - first));
+        std::uint32_t* base = result.Data.data() + first * n;
+        bfs.Run(batch, [base, n](TGraph::TVertextId v, std::uint64_t bits, std::uint32_t level) {
+            for (; bits; bits &= bits - 1) {
+                base[std::countr_zero(bits) * n + v] = level;
+            }
+        });
+    }
+    return result;
+}
+
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges>, e.g. ./a.out 100000 1000000
+// Random graph plus a random spanning tree, so every vertex is reachable from every source
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount) {
+    std::mt19937_64 rng(42);
+    TGraph g;
+    g.Vertices.resize(vertexesCount);
+    for (std::size_t v = 1; v < vertexesCount; ++v) {
+        g.AddEdge(v, rng() % v);
+    }
+    while (g.Edges.size() < edgesCount) {
+        g.AddEdge(rng() % vertexesCount, rng() % vertexesCount);
+    }
+
+    for (std::size_t sourcesCount : {64, 256, 1024}) {
+        std::vector<TGraph::TVertextId> sources(sourcesCount);
+        for (auto& source : sources) {
+            source = rng() % vertexesCount;
+        }
+
+        TMultiSourceDistances multi;
+        double multiTime = MeasureSeconds([&] { multi = MultiSourceDistances(g, sources); });
+
+        TMultiSourceDistances single;
+        double singleTime = MeasureSeconds([&] {
+            single.VerticesCount = vertexesCount;
+            single.Data.assign(sourcesCount * vertexesCount, TMultiSourceDistances::UNREACHED);
+            for (std::size_t i = 0; i < sourcesCount; ++i) {
+                std::uint32_t* row = single.Data.data() + i * vertexesCount;
+                BFS(g, sources[i], [row](TGraph::TVertextId id, const TGraph::TVertexValue&, TGraph::TVertextId, int distance) {
+                    row[id] = distance;
+                    return true;
+                });
+            }
+        });
+
+        std::cout << "sources:" << sourcesCount << " vertexes:" << vertexesCount << " edges:" << g.Edges.size()
+            << " ms-bfs:" << multiTime << "s"
+            << " bfs per source:" << singleTime << "s"
+            << " speedup:" << singleTime / multiTime
+            << " distances:" << multi.Data.size() * sizeof(std::uint32_t) / (1024 * 1024) << "MB"
+            << (multi.Data == single.Data ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
 
-int main() {
     TGraph g;    
     auto r = g.AddVertex("r");
     auto v = g.AddVertex("v");
@@ -109,7 +268,7 @@ int main() {
     auto startpoint = r;
     auto destination = w;
     std::unordered_map<TGraph::TVertextId, TGraph::TVertextId> relations;
-    BFS(g, r, [destination, &relations](TGraph::TVertextId id, const TGraph::TVertexValue& value, TGraph::TVertextId parent, int distance) {
+    BFS(g, r, [destination, &relations](TGraph::TVertextId id, const TGraph::TVertexValue&, TGraph::TVertextId parent, int) {
         relations[id] = parent;
         return id != destination;
     });
@@ -120,5 +279,15 @@ int main() {
     }
     std::cout << startpoint << std::endl;
 
+    std::vector<TGraph::TVertextId> landmarks{r, u, y};
+    auto distances = MultiSourceDistances(g, landmarks);
+    for (std::size_t i = 0; i < landmarks.size(); ++i) {
+        std::cout << "From " << g.Vertices[landmarks[i]].Value << ":";
+        for (TGraph::TVertextId id = 0; id < g.Vertices.size(); ++id) {
+            std::cout << " " << g.Vertices[id].Value << "=" << distances.Of(i)[id];
+        }
+        std::cout << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
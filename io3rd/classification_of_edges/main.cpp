@@ -5,6 +5,14 @@
 #include <unordered_map>
 #include <deque>
 #include <map>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <span>
+#include <chrono>
+#include <random>
+#include <sys/resource.h>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -24,7 +32,7 @@ struct TGraphGeneric {
     };
     using TAdjacencyList = std::vector<TVertextPath>;
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
         TAdjacencyList Adj;
     };
 
@@ -190,9 +198,275 @@ std::string to_string(TDFSContext::EEdgeType e) {
     return mapping.at(e);
 }
 
+// Flat array of 2 bit values, 32 per word, zero initialized
+class TPacked2BitArray {
+public:
+    explicit TPacked2BitArray(std::size_t size)
+        : Words((size + 31) / 32, 0)
+    {
+    }
+
+    std::uint8_t Get(std::size_t i) const {
+        return (Words[i / 32] >> Shift(i)) & 3;
+    }
+
+    void Set(std::size_t i, std::uint8_t value) {
+        auto& word = Words[i / 32];
+        word = (word & ~(std::uint64_t(3) << Shift(i))) | (std::uint64_t(value) << Shift(i));
+    }
 
+    void Clear() {
+        std::fill(Words.begin(), Words.end(), 0);
+    }
+
+    std::size_t MemoryBytes() const {
+        return Words.size() * sizeof(std::uint64_t);
+    }
+
+private:
+    static unsigned Shift(std::size_t i) {
+        return (i % 32) * 2;
+    }
+
+    std::vector<std::uint64_t> Words;
+};
+
+// Every edge is seen once, so there is no Unknown state and a type fits in 2 bits
+enum class ECompactEdgeType : std::uint8_t {
+    Tree,
+    Back,
+    Forward,
+    Cross
+};
+
+TDFSContext::EEdgeType to_edge_type(ECompactEdgeType type) {
+    using EEdgeType = TDFSContext::EEdgeType;
+    switch (type) {
+        case ECompactEdgeType::Tree: return EEdgeType::Tree;
+        case ECompactEdgeType::Back: return EEdgeType::Back;
+        case ECompactEdgeType::Forward: return EEdgeType::Forward;
+        case ECompactEdgeType::Cross: return EEdgeType::Cross;
+    }
+    throw std::runtime_error("unexpected edge type");
+}
+
+struct TClassifiedEdge {
+    std::uint64_t edge;
+    ECompactEdgeType type;
+};
+
+// Edge classification for graphs with billions of edges. Per vertex: 2 bit color and two
+// 32 bit timestamps (10 bytes against 40 of TVertextAttr), per edge: 2 bits (against 4 bytes
+// of TEdgeAttr) or nothing at all when edges are only streamed. The DFS keeps a stack of
+// (vertex, next adjacency index) frames, so every edge is classified exactly once, when its
+// tail scans it, and no parent paths are stored.
+//
+// Classified edges go to the sink in batches of up to batchSize: void(std::span<const TClassifiedEdge>).
+template<typename TGraph>
+class TCompactEdgeClassifier {
+public:
+    using TVertextId = typename TGraph::TVertextId;
+
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 4096;
+
+    explicit TCompactEdgeClassifier(const TGraph& graph, std::size_t batchSize = DEFAULT_BATCH_SIZE)
+        : Graph(graph)
+        , Color(graph.Vertices.size())
+        , Discovery(graph.Vertices.size(), 0)
+        , Finish(graph.Vertices.size(), 0)
+        , BatchSize(std::max<std::size_t>(1, batchSize))
+    {
+        // Every vertex takes two ticks
+        if (graph.Vertices.size() >= std::numeric_limits<std::uint32_t>::max() / 2) {
+            throw std::runtime_error("too many vertices for 32 bit timestamps");
+        }
+        Batch.reserve(BatchSize);
+    }
+
+    // DFS over the whole graph, vertices are roots in id order
+    template<typename TSink>
+    void Classify(TSink&& sink) {
+        Color.Clear();
+        Ticker = 0;
+        for (TVertextId root = 0; root < Graph.Vertices.size(); ++root) {
+            if (Color.Get(root) == White) {
+                Visit(root, sink);
+            }
+        }
+        Flush(sink);
+    }
+
+    // Same, but types are kept in a 2 bit per edge array indexed by edge id
+    TPacked2BitArray Classify() {
+        TPacked2BitArray types(Graph.Edges.size());
+        Classify([&types](std::span<const TClassifiedEdge> batch) {
+            for (const auto& classified : batch) {
+                types.Set(classified.edge, static_cast<std::uint8_t>(classified.type));
+            }
+        });
+        return types;
+    }
+
+    std::uint32_t DiscoveryTime(TVertextId v) const {
+        return Discovery[v];
+    }
+
+    std::uint32_t FinishTime(TVertextId v) const {
+        return Finish[v];
+    }
+
+    std::size_t MemoryBytes() const {
+        return Color.MemoryBytes()
+            + (Discovery.capacity() + Finish.capacity()) * sizeof(std::uint32_t)
+            + Stack.capacity() * sizeof(TFrame)
+            + Batch.capacity() * sizeof(TClassifiedEdge);
+    }
+
+private:
+    enum ECollor : std::uint8_t {
+        White,
+        Gray,
+        Black
+    };
+
+    // Ids fit in 32 bits by the timestamp limit, so a frame is 8 bytes
+    struct TFrame {
+        std::uint32_t vertex;
+        std::uint32_t next;
+    };
+
+    template<typename TSink>
+    void Visit(TVertextId root, TSink& sink) {
+        Open(root);
+        while (!Stack.empty()) {
+            auto& frame = Stack.back();
+            const auto& adj = Graph.Vertices[frame.vertex].Adj;
+            if (frame.next == adj.size()) {
+                Color.Set(frame.vertex, Black);
+                Finish[frame.vertex] = ++Ticker;
+                Stack.pop_back();
+                continue;
+            }
+            const auto& path = adj[frame.next++];
+            const TVertextId from = frame.vertex;
+            const TVertextId to = path.vertex;
+            switch (Color.Get(to)) {
+                case White:
+                    Emit(path.edge, ECompactEdgeType::Tree, sink);
+                    // Invalidates frame
+                    Open(to);
+                    break;
+                case Gray:
+                    Emit(path.edge, ECompactEdgeType::Back, sink);
+                    break;
+                default:
+                    Emit(path.edge, Discovery[from] < Discovery[to] ? ECompactEdgeType::Forward : ECompactEdgeType::Cross, sink);
+                    break;
+            }
+        }
+    }
+
+    void Open(TVertextId v) {
+        Color.Set(v, Gray);
+        Discovery[v] = ++Ticker;
+        Stack.push_back(TFrame{.vertex = static_cast<std::uint32_t>(v), .next = 0});
+    }
+
+    template<typename TSink>
+    void Emit(std::uint64_t edge, ECompactEdgeType type, TSink& sink) {
+        Batch.push_back(TClassifiedEdge{.edge = edge, .type = type});
+        if (Batch.size() == BatchSize) {
+            Flush(sink);
+        }
+    }
+
+    template<typename TSink>
+    void Flush(TSink& sink) {
+        if (!Batch.empty()) {
+            sink(std::span<const TClassifiedEdge>(Batch));
+            Batch.clear();
+        }
+    }
+
+    const TGraph& Graph;
+    TPacked2BitArray Color;
+    std::vector<std::uint32_t> Discovery;
+    std::vector<std::uint32_t> Finish;
+    std::vector<TFrame> Stack;
+    std::vector<TClassifiedEdge> Batch;
+    const std::size_t BatchSize;
+    std::uint32_t Ticker = 0;
+};
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+long PeakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Usage: ./a.out <vertexes> <edges>
+// Compact streaming classification runs first, so the peak RSS growth of TDFSContext is on top of it.
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount) {
+    std::mt19937_64 rng(42);
+    TGraph graph;
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        graph.AddEdge(rng() % vertexesCount, rng() % vertexesCount);
+    }
+
+    long rss = PeakRssKb();
+    std::size_t counts[4] = {};
+    std::size_t compactBytes = 0;
+    double compact = MeasureSeconds([&] {
+        TCompactEdgeClassifier<TGraph> classifier(graph);
+        classifier.Classify([&counts](std::span<const TClassifiedEdge> batch) {
+            for (const auto& classified : batch) {
+                ++counts[static_cast<int>(classified.type)];
+            }
+        });
+        compactBytes = classifier.MemoryBytes();
+    });
+    std::cout << "compact streamed: " << compact << "s"
+        << " state:" << compactBytes / 1024 << "KB"
+        << " peak rss growth:" << (PeakRssKb() - rss) / 1024 << "MB"
+        << " tree:" << counts[0] << " back:" << counts[1]
+        << " forward:" << counts[2] << " cross:" << counts[3] << std::endl;
+
+    rss = PeakRssKb();
+    double packed = MeasureSeconds([&] {
+        TCompactEdgeClassifier<TGraph> classifier(graph);
+        auto types = classifier.Classify();
+        compactBytes = classifier.MemoryBytes() + types.MemoryBytes();
+    });
+    std::cout << "compact packed: " << packed << "s"
+        << " state:" << compactBytes / 1024 << "KB"
+        << " peak rss growth:" << (PeakRssKb() - rss) / 1024 << "MB" << std::endl;
+
+    rss = PeakRssKb();
+    double context = MeasureSeconds([&] {
+        TDFSContext ctx{graph};
+        DFS(graph, ctx);
+    });
+    std::cout << "TDFSContext: " << context << "s"
+        << " state:" << (vertexesCount * sizeof(TDFSContext::TVertextAttr) + edgesCount * sizeof(TDFSContext::TEdgeAttr)) / 1024 << "KB"
+        << " peak rss growth:" << (PeakRssKb() - rss) / 1024 << "MB" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
 
-int main() {
    TGraph graph;    
     auto s = graph.AddVertex("s");
     auto t = graph.AddVertex("t");
@@ -223,7 +497,6 @@ int main() {
     
     TDFSContext ctx{graph};
     DFS(graph, ctx);
-
     for (std::size_t e = 0; e < graph.Edges.size(); ++e) {
         const auto& edge = graph.Edges[e];
         const auto& eattr = ctx.EdgeAttr[e];
@@ -231,6 +504,20 @@ int main() {
             << " has type: " <<  to_string(eattr.edge_type)
             << std::endl;
     }
+
+    // Scans adjacency lists in insertion order, DFS above takes them from the back
+    TCompactEdgeClassifier<TGraph> classifier(graph);
+    auto compact = classifier.Classify();
+    std::cout << "Compact:" << std::endl;
+    for (std::size_t e = 0; e < graph.Edges.size(); ++e) {
+        const auto& edge = graph.Edges[e];
+        std::cout << "Edge: from " << graph.Vertices[edge.v1].Value
+            << " (" << classifier.DiscoveryTime(edge.v1) << "/" << classifier.FinishTime(edge.v1) << ")"
+            << " to " << graph.Vertices[edge.v2].Value
+            << " (" << classifier.DiscoveryTime(edge.v2) << "/" << classifier.FinishTime(edge.v2) << ")"
+            << " has type: " << to_string(to_edge_type(static_cast<ECompactEdgeType>(compact.Get(e))))
+            << std::endl;
+    }
     return 0;
 }
 
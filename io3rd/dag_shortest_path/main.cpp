@@ -1,6 +1,15 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <barrier>
+#include <chrono>
+#include <random>
+#include <cstdint>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -17,7 +26,7 @@ struct TGraphGeneric {
     };
     using TAdjacencyList = std::vector<TVertextPath>;
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
         TAdjacencyList Adj;
     };
 
@@ -168,7 +177,267 @@ void dag_shortest_path(TGraph& graph, TGraph::TVertextId start, TAttrList& attr)
     }
 }
 
-int main() {
+// ---------------- Parallel levelization and relaxation
+
+// Kahn's algorithm level by level: level 0 are vertices without incoming edges, level l+1 are
+// vertices whose last incoming edge comes from level l. Vertices of one level do not depend
+// on each other, so every level is processed by all threads at once.
+// Level l is Order[LevelOffsets[l] .. LevelOffsets[l + 1]).
+struct TDagLevels {
+    std::vector<std::uint32_t> Order;
+    std::vector<std::size_t> LevelOffsets{0};
+    // false if graph has a cycle, Order then holds only vertices not reachable from cycles
+    bool IsDag = true;
+
+    std::size_t LevelsCount() const {
+        return LevelOffsets.size() - 1;
+    }
+};
+
+// Runs body(begin, end, thread) over a level split into contiguous per thread chunks.
+// Threads live for the whole call and levels are separated by a barrier, nextLevel()
+// runs on one thread between levels and returns the size of the next level (0 stops).
+template<typename TBody, typename TNextLevel>
+void ForEachLevel(std::size_t firstLevelSize, std::size_t threadsCount, TBody&& body, TNextLevel&& nextLevel) {
+    std::size_t levelSize = firstLevelSize;
+    auto onCompletion = [&]() noexcept {
+        levelSize = nextLevel();
+    };
+    std::barrier sync(threadsCount, onCompletion);
+    auto worker = [&](std::size_t t) {
+        while (levelSize != 0) {
+            body(levelSize * t / threadsCount, levelSize * (t + 1) / threadsCount, t);
+            sync.arrive_and_wait();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < threadsCount; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+TDagLevels ParallelTopologicalLevels(const TGraph& graph, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+    threadsCount = std::max<std::size_t>(1, threadsCount);
+    const std::size_t n = graph.Vertices.size();
+    std::vector<std::uint32_t> inDegree(n, 0);
+    for (const auto& e : graph.Edges) {
+        ++inDegree[e.v2];
+    }
+
+    TDagLevels levels;
+    for (std::uint32_t v = 0; v < n; ++v) {
+        if (inDegree[v] == 0) {
+            levels.Order.push_back(v);
+        }
+    }
+    levels.LevelOffsets.push_back(levels.Order.size());
+
+    // Thread local frontiers, appended to Order between levels
+    std::vector<std::vector<std::uint32_t>> next(threadsCount);
+    ForEachLevel(levels.Order.size(), threadsCount, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        const std::size_t levelBegin = levels.LevelOffsets[levels.LevelOffsets.size() - 2];
+        for (std::size_t i = levelBegin + begin; i < levelBegin + end; ++i) {
+            for (const auto& adj : graph.Vertices[levels.Order[i]].Adj) {
+                std::atomic_ref<std::uint32_t> degree(inDegree[adj.vertex]);
+                if (degree.fetch_sub(1, std::memory_order_relaxed) == 1) {
+                    next[t].push_back(adj.vertex);
+                }
+            }
+        }
+    }, [&]() {
+        for (auto& local : next) {
+            levels.Order.insert(levels.Order.end(), local.begin(), local.end());
+            local.clear();
+        }
+        std::size_t size = levels.Order.size() - levels.LevelOffsets.back();
+        if (size != 0) {
+            levels.LevelOffsets.push_back(levels.Order.size());
+        }
+        return size;
+    });
+    levels.IsDag = levels.Order.size() == n;
+    return levels;
+}
+
+enum class EPathKind {
+    Shortest,
+    Longest,  // critical path
+};
+
+struct TDagPaths {
+    static constexpr std::int64_t UNREACHED = std::numeric_limits<std::int64_t>::max();
+    static constexpr std::uint32_t NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::int64_t> Distance;
+    std::vector<std::uint32_t> Parent;
+
+    // Vertices from a source to v, empty if v is unreachable
+    std::vector<std::uint32_t> PathTo(std::uint32_t v) const {
+        std::vector<std::uint32_t> path;
+        if (Distance[v] == UNREACHED) {
+            return path;
+        }
+        for (; v != NO_PARENT; v = Parent[v]) {
+            path.push_back(v);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+// Shortest or longest paths from a set of sources over a levelized DAG. Out edges of every
+// level are relaxed in parallel with an atomic min on 64-bit distances, longest path is
+// the shortest one over negated weights. Parents are picked by one more parallel pass over
+// edges, the smallest tight predecessor wins, so the result does not depend on timing.
+TDagPaths ParallelDagPaths(const TGraph& graph, const TDagLevels& levels, const std::vector<std::uint32_t>& sources,
+        EPathKind kind, std::size_t threadsCount = std::thread::hardware_concurrency())
+{
+    threadsCount = std::max<std::size_t>(1, threadsCount);
+    const std::size_t n = graph.Vertices.size();
+    const std::int64_t sign = kind == EPathKind::Shortest ? 1 : -1;
+    TDagPaths paths;
+    paths.Distance.assign(n, TDagPaths::UNREACHED);
+    paths.Parent.assign(n, TDagPaths::NO_PARENT);
+    for (auto s : sources) {
+        paths.Distance[s] = 0;
+    }
+
+    std::size_t level = 0;
+    const std::size_t firstLevelSize = levels.LevelsCount() == 0 ? 0 : levels.LevelOffsets[1];
+    ForEachLevel(firstLevelSize, threadsCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+        const std::size_t levelBegin = levels.LevelOffsets[level];
+        for (std::size_t i = levelBegin + begin; i < levelBegin + end; ++i) {
+            const auto v = levels.Order[i];
+            // All predecessors of v are in earlier levels, its distance is final
+            const auto distance = paths.Distance[v];
+            if (distance == TDagPaths::UNREACHED) {
+                continue;
+            }
+            for (const auto& adj : graph.Vertices[v].Adj) {
+                const auto candidate = distance + sign * graph.Edges[adj.edge].weight;
+                std::atomic_ref<std::int64_t> target(paths.Distance[adj.vertex]);
+                auto current = target.load(std::memory_order_relaxed);
+                while (candidate < current && !target.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    }, [&]() -> std::size_t {
+        ++level;
+        return level < levels.LevelsCount() ? levels.LevelOffsets[level + 1] - levels.LevelOffsets[level] : 0;
+    });
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&, t] {
+            const std::size_t begin = graph.Edges.size() * t / threadsCount;
+            const std::size_t end = graph.Edges.size() * (t + 1) / threadsCount;
+            for (std::size_t e = begin; e < end; ++e) {
+                const auto& edge = graph.Edges[e];
+                const auto from = paths.Distance[edge.v1];
+                if (from == TDagPaths::UNREACHED || from + sign * edge.weight != paths.Distance[edge.v2]) {
+                    continue;
+                }
+                std::atomic_ref<std::uint32_t> parent(paths.Parent[edge.v2]);
+                auto current = parent.load(std::memory_order_relaxed);
+                while (edge.v1 < current && !parent.compare_exchange_weak(current, edge.v1, std::memory_order_relaxed)) {
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (kind == EPathKind::Longest) {
+        for (auto& d : paths.Distance) {
+            if (d != TDagPaths::UNREACHED) {
+                d = -d;
+            }
+        }
+    }
+    return paths;
+}
+
+// Critical path of a task graph: the longest path starting at any task without dependencies
+std::vector<std::uint32_t> CriticalPath(const TGraph& graph, const TDagLevels& levels,
+        std::size_t threadsCount = std::thread::hardware_concurrency())
+{
+    if (levels.Order.empty()) {
+        return {};
+    }
+    std::vector<std::uint32_t> sources(levels.Order.begin(), levels.Order.begin() + levels.LevelOffsets[1]);
+    auto paths = ParallelDagPaths(graph, levels, sources, EPathKind::Longest, threadsCount);
+    std::uint32_t last = sources.front();
+    for (auto v : levels.Order) {
+        if (paths.Distance[v] != TDagPaths::UNREACHED && paths.Distance[v] > paths.Distance[last]) {
+            last = v;
+        }
+    }
+    return paths.PathTo(last);
+}
+
+// Random task graph: every task depends on a few of the previous `window` tasks
+TGraph MakeRandomDag(std::size_t vertexesCount, std::size_t edgesCount, std::size_t window, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 100);
+    TGraph graph;
+    graph.Vertices.reserve(vertexesCount);
+    graph.Edges.reserve(edgesCount);
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        std::size_t v2 = 1 + rng() % (vertexesCount - 1);
+        std::size_t v1 = v2 - 1 - rng() % std::min(window, v2);
+        graph.AddEdge(v1, v2, weight(rng));
+    }
+    return graph;
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <tasks> <dependencies> [window]
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount, std::size_t window) {
+    TGraph graph = MakeRandomDag(vertexesCount, edgesCount, window, 42);
+    const std::size_t threadsCount = std::max(1u, std::thread::hardware_concurrency());
+
+    TAttrList expected;
+    double sequential = MeasureSeconds([&] { dag_shortest_path(graph, 0, expected); });
+
+    TDagLevels levels;
+    TDagPaths shortest;
+    std::vector<std::uint32_t> critical;
+    double levelization = MeasureSeconds([&] { levels = ParallelTopologicalLevels(graph, threadsCount); });
+    double relaxation = MeasureSeconds([&] { shortest = ParallelDagPaths(graph, levels, {0}, EPathKind::Shortest, threadsCount); });
+    double criticalTime = MeasureSeconds([&] { critical = CriticalPath(graph, levels, threadsCount); });
+
+    bool same = true;
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        auto distance = shortest.Distance[v] == TDagPaths::UNREACHED ? INF_WEIGHT : shortest.Distance[v];
+        same = same && distance == expected[v].distance;
+    }
+    std::cout << "tasks:" << vertexesCount << " dependencies:" << graph.Edges.size()
+        << " levels:" << levels.LevelsCount() << " threads:" << threadsCount << std::endl
+        << "    dfs toposort + serial relax: " << sequential << "s" << std::endl
+        << "    parallel levels: " << levelization << "s relax: " << relaxation << "s"
+        << (same ? "" : " MISMATCH") << std::endl
+        << "    critical path: " << criticalTime << "s tasks on path:" << critical.size() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]), argc > 3 ? std::stoul(argv[3]) : 1000);
+        return 0;
+    }
+
     TGraph graph;    
     auto s = graph.AddVertex("s");
     auto t = graph.AddVertex("t");
@@ -194,6 +463,10 @@ int main() {
         std::cout << "verxtex: " << graph.Vertices[v].Value << " distance to s:" << results[v].distance << std::endl;
     }
 
+    // Graph above has cycles, levelization leaves vertices on them out
+    auto levels = ParallelTopologicalLevels(graph);
+    std::cout << "is dag: " << levels.IsDag << " levelized vertices: " << levels.Order.size() << std::endl;
+
     return 0;
 }
 
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// Iterative DFS engine for any graph with Vertices[v].Adj, where adjacency entries are either
+// vertex ids or paths with a .vertex member. The visitor is a template parameter, its hooks
+// are compile time policies: every one of them is optional and a missing hook costs nothing.
+//
+//   bool/void Enter(TVertextId v, std::uint32_t discovery)  - false stops the traversal
+//   void Exit(TVertextId v, std::uint32_t finish)
+//   void Edge(TVertextId from, TVertextId to, EDfsEdge kind)
+//
+// Colors and timestamps live in flat arrays owned by the engine and reused between runs.
+enum class EDfsEdge : std::uint8_t {
+    Tree,
+    Back,
+    Forward,
+    Cross,
+};
+
+template<typename TGraph>
+struct TDfsEngine {
+    using TVertextId = typename TGraph::TVertextId;
+
+    enum ECollor : std::uint8_t {
+        White,
+        Gray,
+        Black
+    };
+
+    explicit TDfsEngine(const TGraph& graph)
+        : Graph(graph)
+        , Color(graph.Vertices.size(), White)
+        , Discovery(graph.Vertices.size(), 0)
+        , Finish(graph.Vertices.size(), 0)
+    {
+    }
+
+    void Reset() {
+        std::fill(Color.begin(), Color.end(), White);
+        Ticker = 0;
+    }
+
+    // Traverses the tree rooted at start, returns false if the visitor stopped it
+    template<typename TVisitor>
+    bool Visit(TVertextId start, TVisitor& visitor) {
+        if (Color[start] != White) {
+            return true;
+        }
+        if (!Open(start, visitor)) {
+            Stack.clear();
+            return false;
+        }
+        while (!Stack.empty()) {
+            const TVertextId from = Stack.back().Vertex;
+            const auto& adj = Graph.Vertices[from].Adj;
+            std::size_t edge = Stack.back().Edge;
+            bool descended = false;
+            // Scan edges of the top vertex until the first white one
+            while (edge < adj.size()) {
+                const TVertextId to = Target(adj[edge++]);
+                if (Color[to] == White) {
+                    Stack.back().Edge = edge;
+                    OnEdge(from, to, EDfsEdge::Tree, visitor);
+                    if (!Open(to, visitor)) {
+                        Stack.clear();
+                        return false;
+                    }
+                    descended = true;
+                    break;
+                }
+                if (Color[to] == Gray) {
+                    OnEdge(from, to, EDfsEdge::Back, visitor);
+                } else {
+                    OnEdge(from, to, Discovery[from] < Discovery[to] ? EDfsEdge::Forward : EDfsEdge::Cross, visitor);
+                }
+            }
+            if (!descended) {
+                Close(from, visitor);
+                Stack.pop_back();
+            }
+        }
+        return true;
+    }
+
+    // Traverses the whole forest in vertex id order
+    template<typename TVisitor>
+    bool VisitAll(TVisitor& visitor) {
+        for (TVertextId v = 0; v < Graph.Vertices.size(); ++v) {
+            if (Color[v] == White && !Visit(v, visitor)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const TGraph& Graph;
+    std::vector<ECollor> Color;
+    std::vector<std::uint32_t> Discovery;
+    std::vector<std::uint32_t> Finish;
+
+private:
+    struct TFrame {
+        TVertextId Vertex;
+        std::size_t Edge;
+    };
+
+    template<typename TAdj>
+    static TVertextId Target(const TAdj& adj) {
+        if constexpr (requires { adj.vertex; }) {
+            return adj.vertex;
+        } else {
+            return adj;
+        }
+    }
+
+    template<typename TVisitor>
+    bool Open(TVertextId v, TVisitor& visitor) {
+        Color[v] = Gray;
+        Discovery[v] = ++Ticker;
+        Stack.push_back(TFrame{.Vertex = v, .Edge = 0});
+        if constexpr (requires { visitor.Enter(v, Ticker); }) {
+            if constexpr (std::is_same_v<decltype(visitor.Enter(v, Ticker)), bool>) {
+                return visitor.Enter(v, Ticker);
+            } else {
+                visitor.Enter(v, Ticker);
+            }
+        }
+        return true;
+    }
+
+    template<typename TVisitor>
+    void Close(TVertextId v, TVisitor& visitor) {
+        Color[v] = Black;
+        Finish[v] = ++Ticker;
+        if constexpr (requires { visitor.Exit(v, Ticker); }) {
+            visitor.Exit(v, Ticker);
+        }
+    }
+
+    template<typename TVisitor>
+    static void OnEdge(TVertextId from, TVertextId to, EDfsEdge kind, TVisitor& visitor) {
+        if constexpr (requires { visitor.Edge(from, to, kind); }) {
+            visitor.Edge(from, to, kind);
+        }
+    }
+
+    std::vector<TFrame> Stack;
+    std::uint32_t Ticker = 0;
+};
@@ -4,6 +4,11 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <deque>
+#include <string>
+#include <chrono>
+#include <random>
+
+#include "dfs_engine.h"
 
 
 struct TGraph {
@@ -89,7 +94,60 @@ void DFS(const TGraph& g, TGraph::TVertextId startingPoint, TVisitor visitor) {
 }
 
 
-int main() {
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges>
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount) {
+    std::mt19937_64 rng(42);
+    TGraph g;
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        g.AddVertex(std::to_string(v));
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        g.AddEdge(rng() % vertexesCount, rng() % vertexesCount);
+    }
+
+    std::size_t visitedFunction = 0;
+    std::size_t sumFunction = 0;
+    double function = MeasureSeconds([&] {
+        DFS(g, 0, [&](TGraph::TVertextId id, const TGraph::TVertexValue&, bool begin, std::size_t) {
+            if (begin) {
+                ++visitedFunction;
+                sumFunction += id;
+            }
+            return true;
+        });
+    });
+
+    struct TCountingVisitor {
+        std::size_t Visited = 0;
+        std::size_t Sum = 0;
+        void Enter(TGraph::TVertextId id, std::uint32_t) {
+            ++Visited;
+            Sum += id;
+        }
+    } visitor;
+    TDfsEngine<TGraph> engine(g);
+    double templated = MeasureSeconds([&] { engine.Visit(0, visitor); });
+
+    std::cout << "dfs vertexes:" << vertexesCount << " edges:" << edgesCount
+        << " std::function:" << function << "s"
+        << " templated:" << templated << "s"
+        << " speedup:" << function / templated
+        << (visitedFunction == visitor.Visited && sumFunction == visitor.Sum ? "" : " MISMATCH") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
     TGraph g;    
     auto r = g.AddVertex("r");
     auto v = g.AddVertex("v");
@@ -116,6 +174,18 @@ int main() {
         return true;
     });
 
+    struct TPrintingVisitor {
+        const TGraph& g;
+        void Enter(TGraph::TVertextId id, std::uint32_t timestamp) {
+            std::cout << "Enter id:" << id << " value:" << g.Vertices[id].Value << " discovery:" << timestamp << std::endl;
+        }
+        void Exit(TGraph::TVertextId id, std::uint32_t timestamp) {
+            std::cout << "Exit id:" << id << " value:" << g.Vertices[id].Value << " finish:" << timestamp << std::endl;
+        }
+    } printer{g};
+    TDfsEngine<TGraph> engine(g);
+    engine.Visit(r, printer);
+
     // auto startpoint = r;
     // auto destination = w;
     // std::unordered_map<TGraph::TVertextId, TGraph::TVertextId> relations;
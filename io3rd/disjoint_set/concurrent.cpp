@@ -0,0 +1,156 @@
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <iostream>
+
+// Concurrent union-find over an index array (Jayanti-Tarjan style).
+// Parent links only ever move from a root to a root of higher priority, so every path
+// is strictly increasing in priority: Find makes at most n steps and each step does
+// at most one CAS which is never retried (path splitting), so it is wait-free.
+// Priority is a fixed bijective hash of the index: that is linking by index,
+// but in a random looking order, which keeps trees shallow on any input.
+struct TConcurrentDisjointSet {
+    using TId = std::uint32_t;
+
+    explicit TConcurrentDisjointSet(std::size_t size)
+        : Parent(size)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            Parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    TId FindSet(TId node) {
+        while (true) {
+            TId parent = Parent[node].load(std::memory_order_acquire);
+            if (parent == node) {
+                return node;
+            }
+            TId grandParent = Parent[parent].load(std::memory_order_acquire);
+            if (parent != grandParent) {
+                // Path splitting: point node to its grandparent. Losing the race is fine,
+                // someone else has moved it even higher.
+                Parent[node].compare_exchange_weak(parent, grandParent, std::memory_order_release, std::memory_order_relaxed);
+            }
+            node = parent;
+        }
+    }
+
+    bool Union(TId x, TId y) {
+        while (true) {
+            x = FindSet(x);
+            y = FindSet(y);
+            if (x == y) {
+                return false;
+            }
+            if (Priority(x) > Priority(y)) {
+                std::swap(x, y);
+            }
+            // Link x under y only if x is still a root, otherwise search again
+            TId expected = x;
+            if (Parent[x].compare_exchange_strong(expected, y, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // Linearizable: if x's root u is still a root after y's root v was found,
+    // then at the moment v was found both were roots and u != v.
+    bool IsSameSet(TId x, TId y) {
+        while (true) {
+            x = FindSet(x);
+            y = FindSet(y);
+            if (x == y) {
+                return true;
+            }
+            if (Parent[x].load(std::memory_order_acquire) == x) {
+                return false;
+            }
+        }
+    }
+
+    std::size_t Size() const {
+        return Parent.size();
+    }
+
+private:
+    static std::uint32_t Priority(TId id) {
+        // murmur3 finalizer, a bijection on 32 bit values
+        std::uint32_t h = id;
+        h ^= h >> 16;
+        h *= 0x85eb'ca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2'ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    std::vector<std::atomic<TId>> Parent;
+};
+
+struct TEdge {
+    std::uint32_t v1;
+    std::uint32_t v2;
+};
+
+std::vector<TEdge> make_random_edges(std::size_t vertexes_count, std::size_t edges_count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, vertexes_count - 1);
+    std::vector<TEdge> edges(edges_count);
+    for (auto& e : edges) {
+        e = TEdge{.v1 = vertex(rng), .v2 = vertex(rng)};
+    }
+    return edges;
+}
+
+// Returns number of successful unions, n - components
+std::size_t parallel_union(TConcurrentDisjointSet& ds, const std::vector<TEdge>& edges, std::size_t threads_count) {
+    std::atomic_size_t unions = 0;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threads_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::size_t local = 0;
+            std::size_t begin = edges.size() * t / threads_count;
+            std::size_t end = edges.size() * (t + 1) / threads_count;
+            for (std::size_t i = begin; i < end; ++i) {
+                local += ds.Union(edges[i].v1, edges[i].v2);
+            }
+            unions += local;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return unions;
+}
+
+// Usage: ./a.out <vertexes> <edges>
+int main(int argc, char* argv[]) {
+    std::size_t vertexes_count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    std::size_t edges_count = argc > 2 ? std::stoul(argv[2]) : 4'000'000;
+    auto edges = make_random_edges(vertexes_count, edges_count, 42);
+
+    std::size_t expected = 0;
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        TConcurrentDisjointSet ds(vertexes_count);
+        auto start = std::chrono::steady_clock::now();
+        std::size_t unions = parallel_union(ds, edges, threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            expected = unions;
+        }
+        // Sanity: every edge ends up inside one set
+        bool same = true;
+        for (const auto& e : edges) {
+            same = same && ds.IsSameSet(e.v1, e.v2);
+        }
+        std::cout << "threads:" << threads << " time:" << seconds << "s"
+            << " unions/s:" << edges.size() / seconds
+            << " components:" << vertexes_count - unions
+            << (same && unions == expected ? "" : " MISMATCH") << std::endl;
+    }
+    return 0;
+}
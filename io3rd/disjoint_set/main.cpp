@@ -1,4 +1,8 @@
 #include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
 
 template<typename T>
 struct DSPrototype {
@@ -59,7 +63,158 @@ private:
     }
 };
 
-int main() {
+enum class ECompression {
+    Full,       // second pass points every node on the path to the root
+    Halving,    // every other node on the path points to its grandparent
+    Splitting,  // every node on the path points to its grandparent
+};
+
+// Index based union-find, 4 bytes per element: Parent[v] >= 0 is the parent of v,
+// negative value marks a root and holds minus size of its set (union by size).
+template<ECompression Compression = ECompression::Halving>
+struct TFlatDisjointSet {
+    using TId = std::uint32_t;
+
+    explicit TFlatDisjointSet(std::size_t size)
+        : Parent(size, -1)
+    {
+    }
+
+    TId FindSet(TId node) {
+        if constexpr (Compression == ECompression::Full) {
+            TId root = node;
+            while (Parent[root] >= 0) {
+                root = Parent[root];
+            }
+            while (node != root) {
+                TId next = Parent[node];
+                Parent[node] = root;
+                node = next;
+            }
+            return root;
+        } else {
+            while (Parent[node] >= 0) {
+                TId parent = Parent[node];
+                if (Parent[parent] < 0) {
+                    return parent;
+                }
+                Parent[node] = Parent[parent];
+                node = Compression == ECompression::Halving ? Parent[parent] : parent;
+            }
+            return node;
+        }
+    }
+
+    bool IsSameSet(TId x, TId y) {
+        return FindSet(x) == FindSet(y);
+    }
+
+    bool Union(TId x, TId y) {
+        x = FindSet(x);
+        y = FindSet(y);
+        if (x == y) {
+            return false;
+        }
+        // Attach smaller set to the bigger one, sizes are negative
+        if (Parent[x] > Parent[y]) {
+            std::swap(x, y);
+        }
+        Parent[x] += Parent[y];
+        Parent[y] = x;
+        return true;
+    }
+
+    std::size_t SetSize(TId node) {
+        return -Parent[FindSet(node)];
+    }
+
+private:
+    std::vector<std::int32_t> Parent;
+};
+
+struct TEdge {
+    std::uint32_t v1;
+    std::uint32_t v2;
+};
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Random unions followed by random same-set queries, returns number of "same" answers
+template<typename TDS>
+std::size_t run_workload(TDS& ds, const std::vector<TEdge>& unions, const std::vector<TEdge>& queries) {
+    for (const auto& e : unions) {
+        ds.Union(e.v1, e.v2);
+    }
+    std::size_t same = 0;
+    for (const auto& e : queries) {
+        same += ds.IsSameSet(e.v1, e.v2);
+    }
+    return same;
+}
+
+struct TNode {
+    DSPrototype<TNode> ds;
+};
+
+// Adapts intrusive DisjointSet to index access for the benchmark
+struct TIntrusiveDisjointSet : DisjointSet<TNode> {
+    explicit TIntrusiveDisjointSet(std::size_t size)
+        : Nodes(size)
+    {
+        for (auto& node : Nodes) {
+            MakeSet(node);
+        }
+    }
+
+    bool Union(std::uint32_t x, std::uint32_t y) {
+        return DisjointSet<TNode>::Union(Nodes[x], Nodes[y]);
+    }
+
+    bool IsSameSet(std::uint32_t x, std::uint32_t y) {
+        return FindSet(&Nodes[x]) == FindSet(&Nodes[y]);
+    }
+
+    std::vector<TNode> Nodes;
+};
+
+template<typename TDS>
+void benchmark(const char* name, std::size_t bytes_per_element, std::size_t size, const std::vector<TEdge>& unions, const std::vector<TEdge>& queries) {
+    std::size_t same = 0;
+    double seconds = measure_seconds([&] {
+        TDS ds(size);
+        same = run_workload(ds, unions, queries);
+    });
+    std::cout << name << " time:" << seconds << "s"
+        << " bytes/element:" << bytes_per_element
+        << " same:" << same << std::endl;
+}
+
+// Usage: ./a.out <elements> <unions> <queries>
+int main(int argc, char* argv[]) {
     // try to solve https://leetcode.com/problems/redundant-connection/submissions/ with DS
-    std::cout << "hello world!" << std::endl;
+    std::size_t size = argc > 1 ? std::stoul(argv[1]) : 10'000'000;
+    std::size_t unions_count = argc > 2 ? std::stoul(argv[2]) : size;
+    std::size_t queries_count = argc > 3 ? std::stoul(argv[3]) : size;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::uint32_t> element(0, size - 1);
+    std::vector<TEdge> unions(unions_count);
+    std::vector<TEdge> queries(queries_count);
+    for (auto& e : unions) {
+        e = TEdge{.v1 = element(rng), .v2 = element(rng)};
+    }
+    for (auto& e : queries) {
+        e = TEdge{.v1 = element(rng), .v2 = element(rng)};
+    }
+
+    benchmark<TFlatDisjointSet<ECompression::Full>>("flat full compression", sizeof(std::int32_t), size, unions, queries);
+    benchmark<TFlatDisjointSet<ECompression::Halving>>("flat path halving", sizeof(std::int32_t), size, unions, queries);
+    benchmark<TFlatDisjointSet<ECompression::Splitting>>("flat path splitting", sizeof(std::int32_t), size, unions, queries);
+    benchmark<TIntrusiveDisjointSet>("intrusive pointers", sizeof(TNode), size, unions, queries);
+    return 0;
 }
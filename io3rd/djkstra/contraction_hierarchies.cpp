@@ -0,0 +1,891 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <sys/resource.h>
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        int weight;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, int weight) {
+        auto edgeId = Edges.size();
+        Edges.emplace_back(v1, v2, weight);
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge=edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge=edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+};
+
+
+using TGraph = TGraphGeneric<true>;
+
+constexpr int INF_WEIGHT = std::numeric_limits<int>::max() / 2;
+
+template<typename TFunc>
+void ParallelChunks(std::size_t count, std::size_t threadsCount, TFunc&& func) {
+    threadsCount = std::max<std::size_t>(1, std::min(threadsCount, count));
+    if (threadsCount == 1) {
+        func(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&func, count, threadsCount, t] {
+            func(count * t / threadsCount, count * (t + 1) / threadsCount, t);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// ---------------- Contraction hierarchies
+
+constexpr std::uint32_t NO_VIA = std::numeric_limits<std::uint32_t>::max();
+
+struct TArc {
+    std::uint32_t target = 0;
+    int weight = 0;
+    // Contracted vertex a shortcut bypasses, NO_VIA for an original edge
+    std::uint32_t via = NO_VIA;
+};
+
+// Vertices ranked by contraction order plus all edges and shortcuts, each stored at its lower
+// ranked end. Up[v] are arcs v -> u with Rank[u] > Rank[v], Down[v] are arcs u -> v with
+// Rank[u] > Rank[v] kept as reversed arcs v -> u: both query searches only climb ranks.
+struct TContractionHierarchy {
+    static constexpr char MAGIC[8] = {'I', 'O', '3', 'C', 'H', 'I', 'E', 'R'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::vector<std::uint32_t> Rank;
+    std::vector<std::uint64_t> UpOffsets;
+    std::vector<TArc> Up;
+    std::vector<std::uint64_t> DownOffsets;
+    std::vector<TArc> Down;
+
+    std::size_t VerticesCount() const {
+        return Rank.size();
+    }
+
+    std::size_t Bytes() const {
+        return Rank.size() * sizeof(Rank[0]) + (UpOffsets.size() + DownOffsets.size()) * sizeof(std::uint64_t)
+            + (Up.size() + Down.size()) * sizeof(TArc);
+    }
+
+    void Save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("can't open " + path + " for writing");
+        }
+        const std::uint64_t counts[3] = {Rank.size(), Up.size(), Down.size()};
+        out.write(MAGIC, sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+        out.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+        auto put = [&out](const auto& data) {
+            out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(data[0]));
+        };
+        put(Rank);
+        put(UpOffsets);
+        put(Up);
+        put(DownOffsets);
+        put(Down);
+        if (!out.flush()) {
+            throw std::runtime_error("can't write " + path);
+        }
+    }
+
+    static TContractionHierarchy Load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("can't open " + path);
+        }
+        char magic[sizeof(MAGIC)];
+        std::uint32_t version = 0;
+        std::uint64_t counts[3];
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(counts), sizeof(counts));
+        if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+            throw std::runtime_error(path + " is not a contraction hierarchy");
+        }
+        TContractionHierarchy hierarchy;
+        auto get = [&in](auto& data, std::uint64_t size) {
+            data.resize(size);
+            in.read(reinterpret_cast<char*>(data.data()), size * sizeof(data[0]));
+        };
+        get(hierarchy.Rank, counts[0]);
+        get(hierarchy.UpOffsets, counts[0] + 1);
+        get(hierarchy.Up, counts[1]);
+        get(hierarchy.DownOffsets, counts[0] + 1);
+        get(hierarchy.Down, counts[2]);
+        if (!in || hierarchy.UpOffsets.back() != counts[1] || hierarchy.DownOffsets.back() != counts[2]) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        return hierarchy;
+    }
+};
+
+// Contracts vertices in rounds. Every round takes an independent set of vertices whose priority
+// is lower than priority of all their neighbours, so their contractions do not touch each other:
+// witness searches and priority updates of a round run in parallel, only inserting shortcuts
+// into the shared overlay graph is serial.
+//
+// Priority is twice the edge difference (shortcuts added - arcs removed) plus the number of
+// already contracted neighbours, which spreads contraction evenly over the graph.
+class TContractionBuilder {
+public:
+    TContractionBuilder(const TGraph& graph, std::size_t threadsCount)
+        : ThreadsCount(std::max<std::size_t>(1, threadsCount))
+        , Out(graph.Vertices.size())
+        , In(graph.Vertices.size())
+        , State(graph.Vertices.size(), Active)
+        , Priority(graph.Vertices.size(), 0)
+        , DeletedNeighbours(graph.Vertices.size(), 0)
+        , Rank(graph.Vertices.size(), 0)
+        , UpArcs(graph.Vertices.size())
+        , DownArcs(graph.Vertices.size())
+    {
+        // Overlay keeps at most one arc per ordered pair, the lightest one, and no self loops
+        for (const auto& edge : graph.Edges) {
+            if (edge.v1 != edge.v2) {
+                AddArc(edge.v1, edge.v2, edge.weight, NO_VIA);
+            }
+        }
+    }
+
+    TContractionHierarchy Build() {
+        const std::size_t n = Out.size();
+        std::vector<TWitnessSearch> searches(ThreadsCount, TWitnessSearch(n));
+        std::vector<std::uint32_t> remaining(n);
+        for (std::uint32_t v = 0; v < n; ++v) {
+            remaining[v] = v;
+        }
+        UpdatePriorities(remaining, searches);
+
+        std::uint32_t nextRank = 0;
+        std::vector<std::vector<std::uint32_t>> localSelected(ThreadsCount);
+        std::vector<std::vector<TShortcut>> localShortcuts(ThreadsCount);
+        std::vector<std::uint32_t> touched;
+        std::vector<bool> isTouched(n, false);
+        while (!remaining.empty()) {
+            // Independent set of local minimums. ParallelChunks runs fewer threads than ThreadsCount
+            // on small rounds, so buffers are cleared here, not by the threads which fill them
+            for (auto& local : localSelected) {
+                local.clear();
+            }
+            ParallelChunks(remaining.size(), ThreadsCount, [&](std::size_t begin, std::size_t end, std::size_t t) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (IsLocalMinimum(remaining[i])) {
+                        localSelected[t].push_back(remaining[i]);
+                    }
+                }
+            });
+            std::vector<std::uint32_t> selected;
+            for (const auto& local : localSelected) {
+                selected.insert(selected.end(), local.begin(), local.end());
+            }
+            for (auto v : selected) {
+                State[v] = Selected;
+            }
+
+            // Shortcuts for every selected vertex, its remaining arcs go to the hierarchy as is
+            for (auto& local : localShortcuts) {
+                local.clear();
+            }
+            ParallelChunks(selected.size(), ThreadsCount, [&](std::size_t begin, std::size_t end, std::size_t t) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    auto v = selected[i];
+                    FindShortcuts(v, searches[t], &localShortcuts[t]);
+                    for (const auto& arc : Out[v]) {
+                        if (State[arc.target] == Active) {
+                            UpArcs[v].push_back(arc);
+                        }
+                    }
+                    for (const auto& arc : In[v]) {
+                        if (State[arc.target] == Active) {
+                            DownArcs[v].push_back(arc);
+                        }
+                    }
+                }
+            });
+
+            touched.clear();
+            for (auto v : selected) {
+                State[v] = Contracted;
+                Rank[v] = nextRank++;
+                for (const auto* arcs : {&Out[v], &In[v]}) {
+                    for (const auto& arc : *arcs) {
+                        if (State[arc.target] == Active) {
+                            ++DeletedNeighbours[arc.target];
+                            if (!isTouched[arc.target]) {
+                                isTouched[arc.target] = true;
+                                touched.push_back(arc.target);
+                            }
+                        }
+                    }
+                }
+                // Arcs of contracted vertices are in UpArcs/DownArcs already
+                Out[v] = {};
+                In[v] = {};
+            }
+            for (const auto& local : localShortcuts) {
+                for (const auto& shortcut : local) {
+                    AddArc(shortcut.from, shortcut.to, shortcut.weight, shortcut.via);
+                }
+            }
+            ShortcutsCount += std::accumulate(localShortcuts.begin(), localShortcuts.end(), std::size_t(0),
+                [](std::size_t sum, const auto& local) { return sum + local.size(); });
+
+            // Neighbours lost arcs to contracted vertices and maybe got shortcuts
+            ParallelChunks(touched.size(), ThreadsCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    auto v = touched[i];
+                    for (auto* arcs : {&Out[v], &In[v]}) {
+                        std::erase_if(*arcs, [this](const TArc& arc) { return State[arc.target] != Active; });
+                    }
+                }
+            });
+            UpdatePriorities(touched, searches);
+            for (auto v : touched) {
+                isTouched[v] = false;
+            }
+            std::erase_if(remaining, [this](std::uint32_t v) { return State[v] != Active; });
+        }
+        return Flatten();
+    }
+
+    std::size_t Shortcuts() const {
+        return ShortcutsCount;
+    }
+
+private:
+    enum EState : std::uint8_t {
+        Active,
+        Selected,
+        Contracted,
+    };
+
+    struct TShortcut {
+        std::uint32_t from;
+        std::uint32_t to;
+        int weight;
+        std::uint32_t via;
+    };
+
+    // Local Dijkstra over active vertices with versioned marks, one per thread
+    struct TWitnessSearch {
+        // Witness search may give up early, that only adds unnecessary shortcuts. Priority
+        // estimation runs far more often than contraction, so it uses a tighter limit.
+        static constexpr std::size_t CONTRACTION_SETTLED = 500;
+        static constexpr std::size_t ESTIMATION_SETTLED = 50;
+
+        explicit TWitnessSearch(std::size_t n)
+            : Distance(n, INF_WEIGHT)
+            , Reached(n, 0)
+            , Target(n, 0)
+        {
+        }
+
+        // Starts a new search, targets are added before Run
+        void Start() {
+            if (++Epoch == 0) {
+                std::fill(Reached.begin(), Reached.end(), 0);
+                std::fill(Target.begin(), Target.end(), 0);
+                Epoch = 1;
+            }
+            Heap.clear();
+            TargetsLeft = 0;
+        }
+
+        void AddTarget(std::uint32_t v) {
+            if (Target[v] != Epoch) {
+                Target[v] = Epoch;
+                ++TargetsLeft;
+            }
+        }
+
+        // Stops once every target is settled, distances above limit are not interesting
+        void Run(const TContractionBuilder& builder, std::uint32_t source, std::uint32_t skip, int limit, std::size_t maxSettled) {
+            Reach(source, 0);
+            std::size_t settled = 0;
+            while (!Heap.empty() && settled < maxSettled && TargetsLeft != 0) {
+                std::pop_heap(Heap.begin(), Heap.end(), std::greater<>());
+                auto [distance, v] = Heap.back();
+                Heap.pop_back();
+                if (distance != Distance[v]) {
+                    continue;
+                }
+                if (distance > limit) {
+                    break;
+                }
+                ++settled;
+                if (Target[v] == Epoch) {
+                    --TargetsLeft;
+                }
+                for (const auto& arc : builder.Out[v]) {
+                    if (arc.target != skip && builder.State[arc.target] == Active) {
+                        Reach(arc.target, distance + arc.weight);
+                    }
+                }
+            }
+        }
+
+        int DistanceTo(std::uint32_t v) const {
+            return Reached[v] == Epoch ? Distance[v] : INF_WEIGHT;
+        }
+
+        void Reach(std::uint32_t v, int distance) {
+            if (Reached[v] == Epoch && Distance[v] <= distance) {
+                return;
+            }
+            Reached[v] = Epoch;
+            Distance[v] = distance;
+            Heap.emplace_back(distance, v);
+            std::push_heap(Heap.begin(), Heap.end(), std::greater<>());
+        }
+
+        std::vector<int> Distance;
+        std::vector<std::uint32_t> Reached;
+        std::vector<std::uint32_t> Target;
+        std::vector<std::pair<int, std::uint32_t>> Heap;
+        std::uint32_t Epoch = 0;
+        std::size_t TargetsLeft = 0;
+    };
+
+    void AddArc(std::uint32_t from, std::uint32_t to, int weight, std::uint32_t via) {
+        auto existing = std::find_if(Out[from].begin(), Out[from].end(), [to](const TArc& arc) { return arc.target == to; });
+        if (existing == Out[from].end()) {
+            Out[from].push_back(TArc{.target = to, .weight = weight, .via = via});
+            In[to].push_back(TArc{.target = from, .weight = weight, .via = via});
+            return;
+        }
+        if (weight < existing->weight) {
+            *existing = TArc{.target = to, .weight = weight, .via = via};
+            auto back = std::find_if(In[to].begin(), In[to].end(), [from](const TArc& arc) { return arc.target == from; });
+            *back = TArc{.target = from, .weight = weight, .via = via};
+        }
+    }
+
+    // Shortcut u -> w is needed when u -> v -> w is the only shortest path, i.e. there is no
+    // witness path avoiding v which is not longer. Returns the number of shortcuts.
+    std::size_t FindShortcuts(std::uint32_t v, TWitnessSearch& search, std::vector<TShortcut>* shortcuts) const {
+        int maxOut = 0;
+        for (const auto& out : Out[v]) {
+            if (State[out.target] == Active) {
+                maxOut = std::max(maxOut, out.weight);
+            }
+        }
+        std::size_t count = 0;
+        for (const auto& in : In[v]) {
+            if (State[in.target] != Active) {
+                continue;
+            }
+            search.Start();
+            for (const auto& out : Out[v]) {
+                if (State[out.target] == Active && out.target != in.target) {
+                    search.AddTarget(out.target);
+                }
+            }
+            search.Run(*this, in.target, v, in.weight + maxOut,
+                shortcuts ? TWitnessSearch::CONTRACTION_SETTLED : TWitnessSearch::ESTIMATION_SETTLED);
+            for (const auto& out : Out[v]) {
+                if (State[out.target] != Active || out.target == in.target) {
+                    continue;
+                }
+                const int viaWeight = in.weight + out.weight;
+                if (search.DistanceTo(out.target) > viaWeight) {
+                    ++count;
+                    if (shortcuts) {
+                        shortcuts->push_back(TShortcut{.from = in.target, .to = out.target, .weight = viaWeight, .via = v});
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    void UpdatePriorities(const std::vector<std::uint32_t>& vertices, std::vector<TWitnessSearch>& searches) {
+        ParallelChunks(vertices.size(), ThreadsCount, [&](std::size_t begin, std::size_t end, std::size_t t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                auto v = vertices[i];
+                auto shortcuts = static_cast<int>(FindShortcuts(v, searches[t], nullptr));
+                auto removed = static_cast<int>(Out[v].size() + In[v].size());
+                Priority[v] = 2 * (shortcuts - removed) + DeletedNeighbours[v];
+            }
+        });
+    }
+
+    // Ties are broken by a hash of the id, so equal priorities don't form long chains, and then by
+    // the id itself: the hash collides above 2^16, and a tie would leave neither vertex a minimum
+    bool Before(std::uint32_t l, std::uint32_t r) const {
+        auto hash = [](std::uint32_t v) { return (v * 0x9E3779B1u) ^ (v >> 16); };
+        if (Priority[l] != Priority[r]) {
+            return Priority[l] < Priority[r];
+        }
+        return hash(l) != hash(r) ? hash(l) < hash(r) : l < r;
+    }
+
+    bool IsLocalMinimum(std::uint32_t v) const {
+        for (const auto* arcs : {&Out[v], &In[v]}) {
+            for (const auto& arc : *arcs) {
+                if (!Before(v, arc.target)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    TContractionHierarchy Flatten() {
+        TContractionHierarchy hierarchy;
+        hierarchy.Rank = std::move(Rank);
+        auto pack = [](std::vector<std::vector<TArc>>& lists, std::vector<std::uint64_t>& offsets, std::vector<TArc>& arcs) {
+            offsets.assign(lists.size() + 1, 0);
+            for (std::size_t v = 0; v < lists.size(); ++v) {
+                offsets[v + 1] = offsets[v] + lists[v].size();
+            }
+            arcs.reserve(offsets.back());
+            for (auto& list : lists) {
+                arcs.insert(arcs.end(), list.begin(), list.end());
+                list = {};
+            }
+        };
+        pack(UpArcs, hierarchy.UpOffsets, hierarchy.Up);
+        pack(DownArcs, hierarchy.DownOffsets, hierarchy.Down);
+        return hierarchy;
+    }
+
+    const std::size_t ThreadsCount;
+    // Overlay graph of active vertices: original arcs and shortcuts
+    std::vector<std::vector<TArc>> Out;
+    std::vector<std::vector<TArc>> In;
+    std::vector<EState> State;
+    std::vector<int> Priority;
+    std::vector<int> DeletedNeighbours;
+    std::vector<std::uint32_t> Rank;
+    std::vector<std::vector<TArc>> UpArcs;
+    std::vector<std::vector<TArc>> DownArcs;
+    std::size_t ShortcutsCount = 0;
+};
+
+TContractionHierarchy BuildContractionHierarchy(const TGraph& graph, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+    return TContractionBuilder(graph, threadsCount).Build();
+}
+
+// Bidirectional upward Dijkstra: forward search from source over Up, backward from target
+// over Down. Every shortest path climbs to its highest ranked vertex and goes down from there,
+// so a direction can stop once its queue top is not shorter than the best meeting found.
+// Scratch arrays are reused between queries through epoch marks.
+class TContractionQuery {
+public:
+    explicit TContractionQuery(const TContractionHierarchy& hierarchy)
+        : Hierarchy(hierarchy)
+        , Forward(hierarchy.VerticesCount())
+        , Backward(hierarchy.VerticesCount())
+    {
+    }
+
+    int Distance(std::uint32_t source, std::uint32_t target) {
+        if (++Epoch == 0) {
+            for (auto* side : {&Forward, &Backward}) {
+                std::fill(side->Reached.begin(), side->Reached.end(), 0);
+            }
+            Epoch = 1;
+        }
+        Best = INF_WEIGHT;
+        Meeting = source;
+        Forward.Start(source, Epoch);
+        Backward.Start(target, Epoch);
+        if (source == target) {
+            Best = 0;
+        }
+        bool forward = true;
+        while (true) {
+            bool forwardDone = Forward.Heap.empty() || Forward.Heap.front().first >= Best;
+            bool backwardDone = Backward.Heap.empty() || Backward.Heap.front().first >= Best;
+            if (forwardDone && backwardDone) {
+                break;
+            }
+            forward = backwardDone || (!forwardDone && !forward);
+            if (forward) {
+                Step(Forward, Backward, Hierarchy.UpOffsets, Hierarchy.Up, Hierarchy.DownOffsets, Hierarchy.Down);
+            } else {
+                Step(Backward, Forward, Hierarchy.DownOffsets, Hierarchy.Down, Hierarchy.UpOffsets, Hierarchy.Up);
+            }
+        }
+        return Best;
+    }
+
+    // Original vertices of the last found path, shortcuts unpacked
+    std::vector<std::uint32_t> Path() const {
+        std::vector<std::uint32_t> path;
+        if (Best == INF_WEIGHT) {
+            return path;
+        }
+        // Arcs on the way up from source, in reverse
+        std::vector<std::pair<std::uint32_t, TArc>> arcs;
+        for (auto v = Meeting; Forward.Parent[v] != v; v = Forward.Parent[v]) {
+            arcs.emplace_back(Forward.Parent[v], TArc{.target = v, .weight = 0, .via = Forward.ParentVia[v]});
+        }
+        std::reverse(arcs.begin(), arcs.end());
+        for (auto v = Meeting; Backward.Parent[v] != v; v = Backward.Parent[v]) {
+            arcs.emplace_back(v, TArc{.target = Backward.Parent[v], .weight = 0, .via = Backward.ParentVia[v]});
+        }
+        auto first = Meeting;
+        for (auto v = Meeting; Forward.Parent[v] != v; v = Forward.Parent[v]) {
+            first = Forward.Parent[v];
+        }
+        path.push_back(first);
+        for (const auto& [from, arc] : arcs) {
+            Unpack(from, arc.target, arc.via, path);
+        }
+        return path;
+    }
+
+private:
+    struct TSide {
+        explicit TSide(std::size_t n)
+            : Distance(n, INF_WEIGHT)
+            , Parent(n, 0)
+            , ParentVia(n, NO_VIA)
+            , Reached(n, 0)
+        {
+        }
+
+        void Start(std::uint32_t v, std::uint32_t epoch) {
+            Heap.clear();
+            Reached[v] = epoch;
+            Distance[v] = 0;
+            Parent[v] = v;
+            ParentVia[v] = NO_VIA;
+            Heap.emplace_back(0, v);
+        }
+
+        std::vector<int> Distance;
+        std::vector<std::uint32_t> Parent;
+        std::vector<std::uint32_t> ParentVia;
+        std::vector<std::uint32_t> Reached;
+        std::vector<std::pair<int, std::uint32_t>> Heap;
+    };
+
+    // Settles one vertex. Stall on demand: if a higher ranked vertex reached by this side has
+    // an arc down to v giving a shorter distance, v is not on a shortest up-down path and its
+    // arcs are not relaxed. Such arcs are the ones the other side climbs over.
+    void Step(TSide& side, const TSide& other, const std::vector<std::uint64_t>& offsets, const std::vector<TArc>& arcs,
+        const std::vector<std::uint64_t>& stallOffsets, const std::vector<TArc>& stallArcs)
+    {
+        std::pop_heap(side.Heap.begin(), side.Heap.end(), std::greater<>());
+        auto [distance, v] = side.Heap.back();
+        side.Heap.pop_back();
+        if (distance != side.Distance[v]) {
+            return;
+        }
+        if (other.Reached[v] == Epoch && distance + other.Distance[v] < Best) {
+            Best = distance + other.Distance[v];
+            Meeting = v;
+        }
+        for (auto i = stallOffsets[v]; i < stallOffsets[v + 1]; ++i) {
+            const auto& arc = stallArcs[i];
+            if (side.Reached[arc.target] == Epoch && side.Distance[arc.target] + arc.weight < distance) {
+                return;
+            }
+        }
+        for (auto i = offsets[v]; i < offsets[v + 1]; ++i) {
+            const auto& arc = arcs[i];
+            const int candidate = distance + arc.weight;
+            if (side.Reached[arc.target] != Epoch || candidate < side.Distance[arc.target]) {
+                side.Reached[arc.target] = Epoch;
+                side.Distance[arc.target] = candidate;
+                side.Parent[arc.target] = v;
+                side.ParentVia[arc.target] = arc.via;
+                side.Heap.emplace_back(candidate, arc.target);
+                std::push_heap(side.Heap.begin(), side.Heap.end(), std::greater<>());
+            }
+        }
+    }
+
+    // Lightest stored arc between from and to that bypasses via (or is original)
+    const TArc* FindArc(std::uint32_t at, std::uint32_t other, const std::vector<std::uint64_t>& offsets, const std::vector<TArc>& arcs) const {
+        const TArc* found = nullptr;
+        for (auto i = offsets[at]; i < offsets[at + 1]; ++i) {
+            if (arcs[i].target == other && (!found || arcs[i].weight < found->weight)) {
+                found = &arcs[i];
+            }
+        }
+        return found;
+    }
+
+    // Appends vertices of arc from -> to after from, shortcuts expanded by explicit stack
+    void Unpack(std::uint32_t from, std::uint32_t to, std::uint32_t via, std::vector<std::uint32_t>& path) const {
+        std::vector<std::pair<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t>> stack{{{from, to}, via}};
+        while (!stack.empty()) {
+            auto [ends, middle] = stack.back();
+            stack.pop_back();
+            if (middle == NO_VIA) {
+                path.push_back(ends.second);
+                continue;
+            }
+            // Middle is ranked below both ends: ends.first -> middle is stored at middle as Down,
+            // middle -> ends.second as Up
+            const TArc* first = FindArc(middle, ends.first, Hierarchy.DownOffsets, Hierarchy.Down);
+            const TArc* second = FindArc(middle, ends.second, Hierarchy.UpOffsets, Hierarchy.Up);
+            stack.push_back({{middle, ends.second}, second->via});
+            stack.push_back({{ends.first, middle}, first->via});
+        }
+    }
+
+    const TContractionHierarchy& Hierarchy;
+    TSide Forward;
+    TSide Backward;
+    std::uint32_t Epoch = 0;
+    int Best = INF_WEIGHT;
+    std::uint32_t Meeting = 0;
+};
+
+// ---------------- Benchmark
+
+// Plain Dijkstra with early stop at target
+int DijkstraDistance(const TGraph& graph, std::uint32_t source, std::uint32_t target, std::vector<int>& distance) {
+    distance.assign(graph.Vertices.size(), INF_WEIGHT);
+    std::priority_queue<std::pair<int, std::uint32_t>, std::vector<std::pair<int, std::uint32_t>>, std::greater<>> heap;
+    distance[source] = 0;
+    heap.emplace(0, source);
+    while (!heap.empty()) {
+        auto [d, v] = heap.top();
+        heap.pop();
+        if (d != distance[v]) {
+            continue;
+        }
+        if (v == target) {
+            return d;
+        }
+        for (const auto& adj : graph.Vertices[v].Adj) {
+            auto candidate = d + graph.Edges[adj.edge].weight;
+            if (candidate < distance[adj.vertex]) {
+                distance[adj.vertex] = candidate;
+                heap.emplace(candidate, adj.vertex);
+            }
+        }
+    }
+    return INF_WEIGHT;
+}
+
+// Road like side x side grid with edges in both directions
+TGraph MakeGridGraph(std::size_t side, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(10, 100);
+    TGraph graph;
+    graph.Vertices.reserve(side * side);
+    for (std::size_t v = 0; v < side * side; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            std::size_t v = r * side + c;
+            if (c + 1 < side) {
+                graph.AddEdge(v, v + 1, weight(rng));
+                graph.AddEdge(v + 1, v, weight(rng));
+            }
+            if (r + 1 < side) {
+                graph.AddEdge(v, v + side, weight(rng));
+                graph.AddEdge(v + side, v, weight(rng));
+            }
+        }
+    }
+    return graph;
+}
+
+long PeakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int PathWeight(const TGraph& graph, const std::vector<std::uint32_t>& path) {
+    int weight = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        int best = INF_WEIGHT;
+        for (const auto& adj : graph.Vertices[path[i - 1]].Adj) {
+            if (adj.vertex == path[i]) {
+                best = std::min(best, graph.Edges[adj.edge].weight);
+            }
+        }
+        weight += best;
+    }
+    return weight;
+}
+
+// Usage: ./a.out <grid side> <queries> [threads]
+void Benchmark(std::size_t side, std::size_t queriesCount, std::size_t threadsCount) {
+    TGraph graph = MakeGridGraph(side, 42);
+    std::mt19937_64 rng(7);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> queries(queriesCount);
+    for (auto& [s, t] : queries) {
+        s = rng() % graph.Vertices.size();
+        t = rng() % graph.Vertices.size();
+    }
+
+    long rssBefore = PeakRssKb();
+    TContractionHierarchy hierarchy;
+    std::size_t shortcuts = 0;
+    double preprocessing = MeasureSeconds([&] {
+        TContractionBuilder builder(graph, threadsCount);
+        hierarchy = builder.Build();
+        shortcuts = builder.Shortcuts();
+    });
+    long rssGrowth = (PeakRssKb() - rssBefore) / 1024;
+
+    const std::string path = "hierarchy.ch";
+    hierarchy.Save(path);
+    auto loaded = TContractionHierarchy::Load(path);
+    std::remove(path.c_str());
+    bool sameLoaded = loaded.Rank == hierarchy.Rank && loaded.UpOffsets == hierarchy.UpOffsets
+        && loaded.Up.size() == hierarchy.Up.size() && loaded.Down.size() == hierarchy.Down.size();
+
+    // Plain Dijkstra is slow, a subset of queries is enough for its rate
+    const std::size_t plainCount = std::min<std::size_t>(queriesCount, 50);
+    std::vector<int> expected(plainCount);
+    std::vector<int> scratch;
+    double plain = MeasureSeconds([&] {
+        for (std::size_t q = 0; q < plainCount; ++q) {
+            expected[q] = DijkstraDistance(graph, queries[q].first, queries[q].second, scratch);
+        }
+    });
+
+    TContractionQuery query(loaded);
+    std::vector<int> distances(queriesCount);
+    double ch = MeasureSeconds([&] {
+        for (std::size_t q = 0; q < queriesCount; ++q) {
+            distances[q] = query.Distance(queries[q].first, queries[q].second);
+        }
+    });
+    bool same = sameLoaded && std::equal(expected.begin(), expected.end(), distances.begin());
+    for (std::size_t q = 0; q < plainCount && same; ++q) {
+        query.Distance(queries[q].first, queries[q].second);
+        auto found = query.Path();
+        same = found.front() == queries[q].first && found.back() == queries[q].second && PathWeight(graph, found) == expected[q];
+    }
+
+    std::cout << "vertexes:" << graph.Vertices.size() << " edges:" << graph.Edges.size() << " threads:" << threadsCount << std::endl
+        << "    preprocessing: " << preprocessing << "s shortcuts:" << shortcuts
+        << " hierarchy:" << (hierarchy.Bytes() >> 20) << "MB peak rss growth:" << rssGrowth << "MB" << std::endl
+        << "    dijkstra: " << plain / plainCount * 1e6 << "us per query" << std::endl
+        << "    ch: " << ch / queriesCount * 1e6 << "us per query" << (same ? "" : " MISMATCH") << std::endl;
+}
+
+// Contraction order does not depend on the number of threads, so neither does the hierarchy.
+// Small grid: its last rounds select fewer vertices than there are threads.
+bool SameForAnyThreadsCount(std::size_t side) {
+    TGraph graph = MakeGridGraph(side, 42);
+    std::size_t expectedShortcuts = 0;
+    TContractionHierarchy expected;
+    bool same = true;
+    for (std::size_t threads : {1, 2, 3, 4, 8, 16, 64}) {
+        TContractionBuilder builder(graph, threads);
+        auto hierarchy = builder.Build();
+        if (threads == 1) {
+            expected = std::move(hierarchy);
+            expectedShortcuts = builder.Shortcuts();
+            continue;
+        }
+        if (builder.Shortcuts() != expectedShortcuts || hierarchy.Rank != expected.Rank) {
+            std::cout << "threads:" << threads << " shortcuts:" << builder.Shortcuts()
+                << " expected:" << expectedShortcuts << " MISMATCH" << std::endl;
+            same = false;
+        }
+    }
+    return same;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]), argc > 3 ? std::stoul(argv[3]) : std::thread::hardware_concurrency());
+        return 0;
+    }
+
+    TGraph graph;
+    auto s = graph.AddVertex("s");
+    auto t = graph.AddVertex("t");
+    auto x = graph.AddVertex("x");
+    auto y = graph.AddVertex("y");
+    auto z = graph.AddVertex("z");
+
+    graph.AddEdge(s, t, 10);
+    graph.AddEdge(s, y, 5);
+    graph.AddEdge(t, x, 1);
+    graph.AddEdge(t, y, 2);
+    graph.AddEdge(x, z, 4);
+    graph.AddEdge(y, x, 9);
+    graph.AddEdge(y, z, 2);
+    graph.AddEdge(y, t, 3);
+    graph.AddEdge(z, x, 6);
+    graph.AddEdge(z, s, 7);
+
+    auto hierarchy = BuildContractionHierarchy(graph);
+    TContractionQuery query(hierarchy);
+    for (TGraph::TVertextId v = 0; v < graph.Vertices.size(); ++v) {
+        std::cout << "verxtex: " << graph.Vertices[v].Value << " distance from s:" << query.Distance(s, v) << " path:";
+        for (auto p : query.Path()) {
+            std::cout << " " << graph.Vertices[p].Value;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "same hierarchy for 1 to 64 threads: " << (SameForAnyThreadsCount(10) ? "yes" : "no") << std::endl;
+    return 0;
+}
@@ -2,6 +2,11 @@
 #include <vector>
 #include <algorithm>
 #include <queue>
+#include <limits>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdint>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -18,7 +23,7 @@ struct TGraphGeneric {
     };
     using TAdjacencyList = std::vector<TVertextPath>;
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
         TAdjacencyList Adj;
     };
 
@@ -103,6 +108,10 @@ void dag_shortest_path(TGraph& graph, TGraph::TVertextId start, TAttrList& attr)
     while(!pq.empty()) {
         auto v = pq.top().vertex;
         pq.pop();
+        if (attr[v].visited) {
+            // stale entry, v was settled with a smaller distance
+            continue;
+        }
         attr[v].visited = true;
         for (const auto& adj : graph.Vertices[v].Adj) { 
             relax(attr, graph.Edges[adj.edge]);
@@ -115,7 +124,313 @@ void dag_shortest_path(TGraph& graph, TGraph::TVertextId start, TAttrList& attr)
     }
 }
 
-int main() {
+// ---------------- Point to point queries
+
+// Source -> target shortest paths on a fixed graph with non-negative weights. Scratch arrays
+// are allocated once and reused: a vertex's distance is valid only if its mark equals the
+// current query epoch, so a new query starts in O(1) instead of reinitializing TAttrList.
+class TPointToPointSearch {
+public:
+    using TVertextId = TGraph::TVertextId;
+
+    explicit TPointToPointSearch(const TGraph& graph)
+        : Graph(graph)
+        , Forward(graph.Vertices.size())
+        , Backward(graph.Vertices.size())
+    {
+        // Incoming edges as CSR for the backward search
+        const std::size_t n = graph.Vertices.size();
+        ReverseOffsets.assign(n + 1, 0);
+        for (const auto& edge : graph.Edges) {
+            ++ReverseOffsets[edge.v2 + 1];
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            ReverseOffsets[v + 1] += ReverseOffsets[v];
+        }
+        ReverseAdj.resize(graph.Edges.size());
+        std::vector<std::size_t> cursor(ReverseOffsets.begin(), ReverseOffsets.end() - 1);
+        for (TVertextId v = 0; v < n; ++v) {
+            for (const auto& adj : graph.Vertices[v].Adj) {
+                ReverseAdj[cursor[adj.vertex]++] = TGraph::TVertextPath{.vertex = v, .edge = adj.edge};
+            }
+        }
+    }
+
+    // Plain Dijkstra that stops once target is settled. Returns INF_WEIGHT if unreachable.
+    int Dijkstra(TVertextId source, TVertextId target) {
+        return AStar(source, target, [](TVertextId) { return 0; });
+    }
+
+    // Dijkstra on reduced costs w(u, v) - h(u) + h(v). The heuristic has to be consistent:
+    // h(u) <= w(u, v) + h(v) and h(target) == 0, e.g. a lower bound of the remaining distance.
+    template<typename THeuristic>
+    int AStar(TVertextId source, TVertextId target, THeuristic&& heuristic) {
+        StartQuery();
+        Meeting = target;
+        Forward.Reach(source, 0, source, Epoch);
+        Forward.Heap.push_back(TVertexInfo{.vertex = source, .weight = heuristic(source)});
+        while (!Forward.Heap.empty()) {
+            auto v = Forward.Pop();
+            if (Forward.Settled[v] == Epoch) {
+                continue;
+            }
+            Forward.Settled[v] = Epoch;
+            ++SettledCount;
+            if (v == target) {
+                return Forward.Distance[v];
+            }
+            for (const auto& adj : Graph.Vertices[v].Adj) {
+                auto candidate = Forward.Distance[v] + Graph.Edges[adj.edge].weight;
+                if (Forward.Improve(adj.vertex, candidate, v, Epoch)) {
+                    Forward.Push(adj.vertex, candidate + heuristic(adj.vertex));
+                }
+            }
+        }
+        return INF_WEIGHT;
+    }
+
+    // Searches from both ends, each step grows the side with the smaller queue top.
+    // Every edge scanned between the two searched areas updates the best path found so far
+    // and the search stops once the two queue tops add up to at least that path.
+    int Bidirectional(TVertextId source, TVertextId target) {
+        StartQuery();
+        int best = source == target ? 0 : INF_WEIGHT;
+        Meeting = source;
+        Forward.Reach(source, 0, source, Epoch);
+        Forward.Push(source, 0);
+        Backward.Reach(target, 0, target, Epoch);
+        Backward.Push(target, 0);
+
+        while (!Forward.Heap.empty() && !Backward.Heap.empty()) {
+            if (Forward.Heap.front().weight + Backward.Heap.front().weight >= best) {
+                break;
+            }
+            const bool forward = Forward.Heap.front().weight <= Backward.Heap.front().weight;
+            auto& side = forward ? Forward : Backward;
+            auto& other = forward ? Backward : Forward;
+            auto v = side.Pop();
+            if (side.Settled[v] == Epoch) {
+                continue;
+            }
+            side.Settled[v] = Epoch;
+            ++SettledCount;
+            auto scan = [&](const TGraph::TVertextPath& adj) {
+                auto candidate = side.Distance[v] + Graph.Edges[adj.edge].weight;
+                if (side.Improve(adj.vertex, candidate, v, Epoch)) {
+                    side.Push(adj.vertex, candidate);
+                }
+                if (other.Reached[adj.vertex] == Epoch && candidate + other.Distance[adj.vertex] < best) {
+                    best = candidate + other.Distance[adj.vertex];
+                    Meeting = adj.vertex;
+                }
+            };
+            if (forward) {
+                for (const auto& adj : Graph.Vertices[v].Adj) {
+                    scan(adj);
+                }
+            } else {
+                for (auto i = ReverseOffsets[v]; i < ReverseOffsets[v + 1]; ++i) {
+                    scan(ReverseAdj[i]);
+                }
+            }
+        }
+        LastBidirectional = true;
+        return best;
+    }
+
+    // Vertices of the path found by the last query, empty if there is none
+    std::vector<TVertextId> Path(TVertextId source, TVertextId target) const {
+        std::vector<TVertextId> path;
+        if (Forward.Reached[Meeting] != Epoch || (LastBidirectional && Backward.Reached[Meeting] != Epoch)) {
+            return path;
+        }
+        for (auto v = Meeting; v != source; v = Forward.Parent[v]) {
+            path.push_back(v);
+        }
+        path.push_back(source);
+        std::reverse(path.begin(), path.end());
+        if (LastBidirectional) {
+            for (auto v = Meeting; v != target; ) {
+                v = Backward.Parent[v];
+                path.push_back(v);
+            }
+        }
+        return path;
+    }
+
+    // Vertices settled by the last query
+    std::size_t Settled() const {
+        return SettledCount;
+    }
+
+private:
+    struct TSide {
+        explicit TSide(std::size_t n)
+            : Distance(n, INF_WEIGHT)
+            , Parent(n, 0)
+            , Reached(n, 0)
+            , Settled(n, 0)
+        {
+        }
+
+        void Reach(TVertextId v, int distance, TVertextId parent, std::uint32_t epoch) {
+            Distance[v] = distance;
+            Parent[v] = parent;
+            Reached[v] = epoch;
+        }
+
+        bool Improve(TVertextId v, int distance, TVertextId parent, std::uint32_t epoch) {
+            if (Reached[v] == epoch && Distance[v] <= distance) {
+                return false;
+            }
+            Reach(v, distance, parent, epoch);
+            return true;
+        }
+
+        void Push(TVertextId v, int key) {
+            Heap.push_back(TVertexInfo{.vertex = v, .weight = key});
+            std::push_heap(Heap.begin(), Heap.end());
+        }
+
+        TVertextId Pop() {
+            std::pop_heap(Heap.begin(), Heap.end());
+            auto v = Heap.back().vertex;
+            Heap.pop_back();
+            return v;
+        }
+
+        std::vector<int> Distance;
+        std::vector<TVertextId> Parent;
+        // Distance/Parent of v are valid when Reached[v] is the current epoch
+        std::vector<std::uint32_t> Reached;
+        std::vector<std::uint32_t> Settled;
+        std::vector<TVertexInfo> Heap;
+    };
+
+    void StartQuery() {
+        if (++Epoch == 0) {
+            // Marks wrapped around, the only time arrays are cleared
+            for (auto* side : {&Forward, &Backward}) {
+                std::fill(side->Reached.begin(), side->Reached.end(), 0);
+                std::fill(side->Settled.begin(), side->Settled.end(), 0);
+            }
+            Epoch = 1;
+        }
+        Forward.Heap.clear();
+        Backward.Heap.clear();
+        SettledCount = 0;
+        LastBidirectional = false;
+    }
+
+    const TGraph& Graph;
+    std::vector<std::size_t> ReverseOffsets;
+    std::vector<TGraph::TVertextPath> ReverseAdj;
+    TSide Forward;
+    TSide Backward;
+    std::uint32_t Epoch = 0;
+    TVertextId Meeting = 0;
+    std::size_t SettledCount = 0;
+    bool LastBidirectional = false;
+};
+
+// Road like side x side grid with edges in both directions, weight >= MIN_GRID_WEIGHT
+constexpr int MIN_GRID_WEIGHT = 10;
+
+TGraph MakeGridGraph(std::size_t side, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(MIN_GRID_WEIGHT, 100);
+    TGraph graph;
+    graph.Vertices.reserve(side * side);
+    for (std::size_t v = 0; v < side * side; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            std::size_t v = r * side + c;
+            if (c + 1 < side) {
+                graph.AddEdge(v, v + 1, weight(rng));
+                graph.AddEdge(v + 1, v, weight(rng));
+            }
+            if (r + 1 < side) {
+                graph.AddEdge(v, v + side, weight(rng));
+                graph.AddEdge(v + side, v, weight(rng));
+            }
+        }
+    }
+    return graph;
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <grid side> <queries>
+void Benchmark(std::size_t side, std::size_t queriesCount) {
+    TGraph graph = MakeGridGraph(side, 42);
+    std::mt19937_64 rng(7);
+    std::vector<std::pair<TGraph::TVertextId, TGraph::TVertextId>> queries(queriesCount);
+    for (auto& [s, t] : queries) {
+        s = rng() % graph.Vertices.size();
+        t = rng() % graph.Vertices.size();
+    }
+    // Manhattan distance times the smallest weight never overestimates
+    auto manhattan = [side](TGraph::TVertextId target) {
+        return [side, target](TGraph::TVertextId v) {
+            auto dr = static_cast<long>(v / side) - static_cast<long>(target / side);
+            auto dc = static_cast<long>(v % side) - static_cast<long>(target % side);
+            return static_cast<int>((std::abs(dr) + std::abs(dc)) * MIN_GRID_WEIGHT);
+        };
+    };
+
+    // Full single source search with fresh TAttrList per query is slow, so only a few of them
+    const std::size_t fullCount = std::min<std::size_t>(queriesCount, 20);
+    std::vector<int> expected(fullCount);
+    double full = MeasureSeconds([&] {
+        for (std::size_t q = 0; q < fullCount; ++q) {
+            TAttrList attr;
+            dag_shortest_path(graph, queries[q].first, attr);
+            expected[q] = attr[queries[q].second].distance;
+        }
+    });
+    std::cout << "vertexes:" << graph.Vertices.size() << " edges:" << graph.Edges.size() << std::endl
+        << "    full dijkstra: " << fullCount / full << " queries/s" << std::endl;
+
+    TPointToPointSearch search(graph);
+    const char* names[] = {"early stop dijkstra", "bidirectional", "a* manhattan"};
+    std::vector<int> reference;
+    for (int kind = 0; kind < 3; ++kind) {
+        std::vector<int> distances(queriesCount);
+        std::size_t settled = 0;
+        double seconds = MeasureSeconds([&] {
+            for (std::size_t q = 0; q < queriesCount; ++q) {
+                auto [s, t] = queries[q];
+                switch (kind) {
+                    case 0: distances[q] = search.Dijkstra(s, t); break;
+                    case 1: distances[q] = search.Bidirectional(s, t); break;
+                    default: distances[q] = search.AStar(s, t, manhattan(t)); break;
+                }
+                settled += search.Settled();
+            }
+        });
+        if (kind == 0) {
+            reference = distances;
+        }
+        bool same = distances == reference && std::equal(expected.begin(), expected.end(), distances.begin());
+        std::cout << "    " << names[kind] << ": " << queriesCount / seconds << " queries/s"
+            << " settled per query:" << settled / std::max<std::size_t>(1, queriesCount)
+            << (same ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
     TGraph graph;    
     auto s = graph.AddVertex("s");
     auto t = graph.AddVertex("t");
@@ -141,6 +456,13 @@ int main() {
         std::cout << "verxtex: " << graph.Vertices[v].Value << " distance from s:" << results[v].distance << std::endl;
     }
 
+    TPointToPointSearch search(graph);
+    std::cout << "bidirectional s -> x: " << search.Bidirectional(s, x) << " path:";
+    for (auto v : search.Path(s, x)) {
+        std::cout << " " << graph.Vertices[v].Value;
+    }
+    std::cout << std::endl;
+
     return 0;
 }
 
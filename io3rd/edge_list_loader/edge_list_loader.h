@@ -0,0 +1,433 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <exception>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Multi-threaded loader of "u v [w]" text edge lists. The file is memory mapped and split into
+// one chunk per thread on newline boundaries. Every thread parses its chunk without iostreams
+// into a local edge list and local per vertex degrees, then the partial adjacency is merged
+// into one CSR by a parallel prefix sum over (vertex, thread). Adjacency comes out in the same
+// order as calling AddEdge line by line would produce.
+//
+// Per (vertex, thread) counters take 4 * threads * vertices bytes. That is only paid while it
+// is not more than 4 bytes per adjacency entry. Sparser inputs (32 threads and 100M vertices
+// would be 12.8GB of counters) share one atomic counter per vertex, scatter in any order and
+// then sort every adjacency by edge id, which is line order again. Either way the extra memory
+// is O(vertices + edges) on top of the CSR.
+//
+// Vertex ids are non-negative integers, the largest one defines the number of vertices.
+// A missing weight is 1. Empty lines and lines starting with '#' or '%' are skipped.
+namespace NEdgeList {
+
+using TVertextId = std::uint32_t;
+using TEdgeId = std::uint32_t;
+
+struct TEdge {
+    TVertextId v1;
+    TVertextId v2;
+    int weight;
+};
+
+// Same layout as TGraphGeneric::TVertextPath, target and edge id share a cache line
+struct TVertextPath {
+    TVertextId vertex = 0;
+    TEdgeId edge = 0;
+};
+
+struct TCsrGraph {
+    // Adjacency of v is Adj[Offsets[v] .. Offsets[v + 1])
+    std::vector<std::uint64_t> Offsets;
+    std::vector<TVertextPath> Adj;
+    std::vector<TEdge> Edges;
+
+    std::size_t VerticesCount() const {
+        return Offsets.size() - 1;
+    }
+};
+
+// Read only mapping of a whole file
+class TMappedFile {
+public:
+    explicit TMappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("can't open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("can't stat " + path);
+        }
+        Size = st.st_size;
+        if (Size != 0) {
+            void* data = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("can't map " + path);
+            }
+            ::madvise(data, Size, MADV_SEQUENTIAL);
+            Data = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    TMappedFile(const TMappedFile&) = delete;
+    TMappedFile& operator=(const TMappedFile&) = delete;
+
+    ~TMappedFile() {
+        if (Data) {
+            ::munmap(const_cast<char*>(Data), Size);
+        }
+    }
+
+    const char* Data = nullptr;
+    std::size_t Size = 0;
+};
+
+template<typename TFunc>
+void ParallelChunks(std::size_t count, std::size_t threadsCount, TFunc&& func) {
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < threadsCount; ++t) {
+        threads.emplace_back([&, t] {
+            func(count * t / threadsCount, count * (t + 1) / threadsCount, t);
+        });
+    }
+    func(0, count / threadsCount, 0);
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+namespace NPrivate {
+
+// Adjacency and counters are filled in random order, transparent huge pages save most of the
+// TLB misses there. Fresh capacity is not touched yet, so the advice applies before zeroing.
+template<typename T>
+void ResizeHuge(std::vector<T>& data, std::size_t size, const T& value) {
+    constexpr std::uintptr_t HUGE_PAGE = 2 << 20;
+    data.clear();
+    data.reserve(size);
+    std::uintptr_t from = (reinterpret_cast<std::uintptr_t>(data.data()) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+    std::uintptr_t to = reinterpret_cast<std::uintptr_t>(data.data() + size) & ~(HUGE_PAGE - 1);
+    if (from < to) {
+        ::madvise(reinterpret_cast<void*>(from), to - from, MADV_HUGEPAGE);
+    }
+    data.resize(size, value);
+}
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parses one integer at pos, returns false if there is no number before the end of the line
+template<typename TInt>
+bool ParseNumber(const char*& pos, const char* end, TInt& result) {
+    while (pos < end && IsSpace(*pos)) {
+        ++pos;
+    }
+    bool negative = false;
+    if (pos < end && *pos == '-') {
+        negative = true;
+        ++pos;
+    }
+    if (pos == end || static_cast<unsigned char>(*pos - '0') > 9) {
+        return false;
+    }
+    std::uint64_t value = 0;
+    while (pos < end && static_cast<unsigned char>(*pos - '0') <= 9) {
+        value = value * 10 + (*pos++ - '0');
+    }
+    result = static_cast<TInt>(negative ? 0 - value : value);
+    return true;
+}
+
+struct TPartial {
+    std::vector<TEdge> Edges;
+    TVertextId MaxVertex = 0;
+    // Entries this thread adds to every vertex, turned into write cursors relative to
+    // Offsets[v] during the merge. This is threads * vertices counters, so 32 bits are used.
+    std::vector<std::uint32_t> Degree;
+};
+
+// One pass over the chunk, numbers are parsed straight from the mapping
+inline void ParseChunk(const char* pos, const char* end, const char* fileBegin, TPartial& partial) {
+    while (pos < end) {
+        const char* line = pos;
+        while (pos < end && IsSpace(*pos)) {
+            ++pos;
+        }
+        if (pos == end) {
+            break;
+        }
+        if (*pos == '\n') {
+            ++pos;
+            continue;
+        }
+        if (*pos == '#' || *pos == '%') {
+            const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            pos = newline ? newline + 1 : end;
+            continue;
+        }
+        TEdge edge{.v1 = 0, .v2 = 0, .weight = 1};
+        std::int64_t v1 = -1;
+        std::int64_t v2 = -1;
+        bool ok = ParseNumber(pos, end, v1) && ParseNumber(pos, end, v2)
+            && v1 >= 0 && v2 >= 0 && v1 < UINT32_MAX && v2 < UINT32_MAX;
+        ParseNumber(pos, end, edge.weight);
+        while (pos < end && IsSpace(*pos)) {
+            ++pos;
+        }
+        if (!ok || (pos < end && *pos++ != '\n')) {
+            throw std::runtime_error("bad edge at byte " + std::to_string(line - fileBegin));
+        }
+        edge.v1 = v1;
+        edge.v2 = v2;
+        partial.MaxVertex = std::max(partial.MaxVertex, std::max(edge.v1, edge.v2));
+        partial.Edges.push_back(edge);
+    }
+}
+
+// Merge for sparse inputs: one shared counter per vertex instead of one per (vertex, thread)
+template<bool Directed>
+void MergeShared(TCsrGraph& graph, std::vector<TPartial>& partials, const std::vector<std::size_t>& edgeBase, std::size_t threadsCount) {
+    const std::size_t n = graph.Offsets.size() - 1;
+    std::vector<std::atomic<std::uint32_t>> degree(n);
+    ParallelChunks(threadsCount, threadsCount, [&](std::size_t, std::size_t, std::size_t t) {
+        const auto& partial = partials[t];
+        std::copy(partial.Edges.begin(), partial.Edges.end(), graph.Edges.begin() + edgeBase[t]);
+        for (const auto& edge : partial.Edges) {
+            degree[edge.v1].fetch_add(1, std::memory_order_relaxed);
+            if (!Directed) {
+                degree[edge.v2].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Same two pass prefix sum as the per thread merge, counters become write cursors
+    std::vector<std::uint64_t> rangeTotal(threadsCount + 1, 0);
+    ParallelChunks(n, threadsCount, [&](std::size_t from, std::size_t to, std::size_t t) {
+        std::uint64_t total = 0;
+        for (std::size_t v = from; v < to; ++v) {
+            total += degree[v].load(std::memory_order_relaxed);
+        }
+        rangeTotal[t + 1] = total;
+    });
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        rangeTotal[t + 1] += rangeTotal[t];
+    }
+    ParallelChunks(n, threadsCount, [&](std::size_t from, std::size_t to, std::size_t t) {
+        std::uint64_t position = rangeTotal[t];
+        for (std::size_t v = from; v < to; ++v) {
+            graph.Offsets[v] = position;
+            position += degree[v].load(std::memory_order_relaxed);
+            degree[v].store(0, std::memory_order_relaxed);
+        }
+        if (t + 1 == threadsCount) {
+            graph.Offsets[n] = position;
+        }
+    });
+
+    ParallelChunks(threadsCount, threadsCount, [&](std::size_t, std::size_t, std::size_t t) {
+        auto& partial = partials[t];
+        TEdgeId edgeId = edgeBase[t];
+        for (const auto& edge : partial.Edges) {
+            auto slot = graph.Offsets[edge.v1] + degree[edge.v1].fetch_add(1, std::memory_order_relaxed);
+            graph.Adj[slot] = TVertextPath{.vertex = edge.v2, .edge = edgeId};
+            if (!Directed) {
+                slot = graph.Offsets[edge.v2] + degree[edge.v2].fetch_add(1, std::memory_order_relaxed);
+                graph.Adj[slot] = TVertextPath{.vertex = edge.v1, .edge = edgeId};
+            }
+            ++edgeId;
+        }
+        partial = TPartial{};
+    });
+
+    // Edge ids follow the lines, so sorting by them restores the AddEdge order
+    ParallelChunks(n, threadsCount, [&](std::size_t from, std::size_t to, std::size_t) {
+        for (std::size_t v = from; v < to; ++v) {
+            std::sort(graph.Adj.begin() + graph.Offsets[v], graph.Adj.begin() + graph.Offsets[v + 1],
+                [](const TVertextPath& l, const TVertextPath& r) { return l.edge < r.edge; });
+        }
+    });
+}
+
+} // namespace NPrivate
+
+template<bool Directed>
+TCsrGraph Load(const std::string& path, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+    using namespace NPrivate;
+    threadsCount = std::max<std::size_t>(1, threadsCount);
+    TMappedFile file(path);
+    const char* begin = file.Data;
+    const char* end = file.Data + file.Size;
+
+    // Chunk t starts right after the first newline at or after t * size / threads
+    std::vector<const char*> bounds(threadsCount + 1, end);
+    bounds[0] = begin;
+    for (std::size_t t = 1; t < threadsCount; ++t) {
+        const char* pos = std::max(begin + file.Size * t / threadsCount, bounds[t - 1]);
+        const char* newline = pos < end ? static_cast<const char*>(std::memchr(pos, '\n', end - pos)) : nullptr;
+        bounds[t] = newline ? newline + 1 : end;
+    }
+
+    std::vector<TPartial> partials(threadsCount);
+    std::vector<std::exception_ptr> errors(threadsCount);
+    ParallelChunks(threadsCount, threadsCount, [&](std::size_t, std::size_t, std::size_t t) {
+        try {
+            partials[t].Edges.reserve((bounds[t + 1] - bounds[t]) / 16);
+            ParseChunk(bounds[t], bounds[t + 1], begin, partials[t]);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    });
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    TCsrGraph graph;
+    std::size_t n = 0;
+    std::vector<std::size_t> edgeBase(threadsCount + 1, 0);
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        if (!partials[t].Edges.empty()) {
+            n = std::max<std::size_t>(n, partials[t].MaxVertex + 1);
+        }
+        edgeBase[t + 1] = edgeBase[t] + partials[t].Edges.size();
+    }
+    const std::size_t edgesCount = edgeBase[threadsCount];
+    if (edgesCount >= UINT32_MAX) {
+        throw std::length_error("too many edges for 32-bit edge ids");
+    }
+    const std::size_t adjCount = Directed ? edgesCount : 2 * edgesCount;
+    ResizeHuge<std::uint64_t>(graph.Offsets, n + 1, 0);
+    graph.Edges.resize(edgesCount);
+    ResizeHuge(graph.Adj, adjCount, TVertextPath{});
+    if (threadsCount * n > adjCount) {
+        MergeShared<Directed>(graph, partials, edgeBase, threadsCount);
+        return graph;
+    }
+
+    // Local degrees, edge list is copied into its final place on the way
+    ParallelChunks(threadsCount, threadsCount, [&](std::size_t, std::size_t, std::size_t t) {
+        auto& partial = partials[t];
+        ResizeHuge<std::uint32_t>(partial.Degree, n, 0);
+        std::copy(partial.Edges.begin(), partial.Edges.end(), graph.Edges.begin() + edgeBase[t]);
+        for (const auto& edge : partial.Edges) {
+            ++partial.Degree[edge.v1];
+            if (!Directed) {
+                ++partial.Degree[edge.v2];
+            }
+        }
+    });
+
+    // Prefix sum in (vertex, thread) order: every thread scans a range of vertices, range totals
+    // are scanned serially, then the ranges are scanned again with their base
+    std::vector<std::uint64_t> rangeTotal(threadsCount + 1, 0);
+    ParallelChunks(n, threadsCount, [&](std::size_t from, std::size_t to, std::size_t t) {
+        std::uint64_t total = 0;
+        for (std::size_t v = from; v < to; ++v) {
+            for (const auto& partial : partials) {
+                total += partial.Degree[v];
+            }
+        }
+        rangeTotal[t + 1] = total;
+    });
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        rangeTotal[t + 1] += rangeTotal[t];
+    }
+    ParallelChunks(n, threadsCount, [&](std::size_t from, std::size_t to, std::size_t t) {
+        std::uint64_t position = rangeTotal[t];
+        for (std::size_t v = from; v < to; ++v) {
+            graph.Offsets[v] = position;
+            std::uint32_t cursor = 0;
+            for (auto& partial : partials) {
+                auto degree = partial.Degree[v];
+                partial.Degree[v] = cursor;
+                cursor += degree;
+            }
+            position += cursor;
+        }
+        if (t + 1 == threadsCount) {
+            graph.Offsets[n] = position;
+        }
+    });
+
+    // Scatter: every thread owns its cursors, so no two threads write the same slot
+    ParallelChunks(threadsCount, threadsCount, [&](std::size_t, std::size_t, std::size_t t) {
+        auto& partial = partials[t];
+        TEdgeId edgeId = edgeBase[t];
+        for (const auto& edge : partial.Edges) {
+            graph.Adj[graph.Offsets[edge.v1] + partial.Degree[edge.v1]++] = TVertextPath{.vertex = edge.v2, .edge = edgeId};
+            if (!Directed) {
+                graph.Adj[graph.Offsets[edge.v2] + partial.Degree[edge.v2]++] = TVertextPath{.vertex = edge.v1, .edge = edgeId};
+            }
+            ++edgeId;
+        }
+        partial = TPartial{};
+    });
+    return graph;
+}
+
+// Fills a TGraphGeneric-like graph from CSR: the io3rd copies (Value inside TVertex) as well as
+// the templated graph of graph_generic.h. Vertex values are decimal ids when the value type is
+// constructible from a string, default ones otherwise. Weights are converted to the graph's
+// weight type, graphs without arithmetic weights (TNoWeight) drop them.
+template<typename TGraph>
+TGraph ToGraph(const TCsrGraph& csr, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+    using TVertexValue = typename TGraph::TVertexValue;
+    using TGraphEdge = typename TGraph::TEdge;
+    constexpr bool weighted = requires { requires std::is_arithmetic_v<decltype(TGraphEdge::weight)>; };
+    threadsCount = std::max<std::size_t>(1, threadsCount);
+    TGraph graph;
+    if constexpr (requires { graph.Resize(csr.VerticesCount()); }) {
+        graph.Resize(csr.VerticesCount());
+    } else {
+        graph.Vertices.resize(csr.VerticesCount());
+    }
+    graph.Edges.resize(csr.Edges.size());
+    ParallelChunks(csr.Edges.size(), threadsCount, [&](std::size_t from, std::size_t to, std::size_t) {
+        for (std::size_t e = from; e < to; ++e) {
+            const auto& edge = csr.Edges[e];
+            if constexpr (weighted) {
+                graph.Edges[e] = {edge.v1, edge.v2, static_cast<decltype(TGraphEdge::weight)>(edge.weight)};
+            } else {
+                graph.Edges[e] = {edge.v1, edge.v2};
+            }
+        }
+    });
+    ParallelChunks(csr.VerticesCount(), threadsCount, [&](std::size_t from, std::size_t to, std::size_t) {
+        for (std::size_t v = from; v < to; ++v) {
+            auto& vertex = graph.Vertices[v];
+            if constexpr (std::is_constructible_v<TVertexValue, std::string>) {
+                if constexpr (requires { vertex.Value; }) {
+                    vertex.Value = TVertexValue(std::to_string(v));
+                } else {
+                    graph.Payloads.Get(v) = TVertexValue(std::to_string(v));
+                }
+            }
+            vertex.Adj.resize(csr.Offsets[v + 1] - csr.Offsets[v]);
+            for (std::size_t i = 0; i < vertex.Adj.size(); ++i) {
+                const auto& adj = csr.Adj[csr.Offsets[v] + i];
+                vertex.Adj[i].vertex = adj.vertex;
+                vertex.Adj[i].edge = adj.edge;
+            }
+        }
+    });
+    return graph;
+}
+
+} // namespace NEdgeList
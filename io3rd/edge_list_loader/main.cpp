@@ -0,0 +1,192 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <charconv>
+#include <cstdio>
+
+#include "edge_list_loader.h"
+
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        int weight;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, int weight) {
+        auto edgeId = Edges.size();
+        Edges.emplace_back(v1, v2, weight);
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge=edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge=edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+};
+
+
+
+using TGraph = TGraphGeneric<false>;
+
+// The way graphs are built in the other examples: iostreams and AddEdge line by line
+TGraph LoadWithAddEdge(const std::string& path) {
+    std::ifstream in(path);
+    TGraph graph;
+    std::size_t v1 = 0;
+    std::size_t v2 = 0;
+    int weight = 0;
+    while (in >> v1 >> v2 >> weight) {
+        while (graph.Vertices.size() <= std::max(v1, v2)) {
+            graph.AddVertex(std::to_string(graph.Vertices.size()));
+        }
+        graph.AddEdge(v1, v2, weight);
+    }
+    return graph;
+}
+
+void WriteRandomEdgeList(const std::string& path, std::size_t vertexesCount, std::size_t edgesCount, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        throw std::runtime_error("can't open " + path);
+    }
+    std::vector<char> buffer(1 << 20);
+    std::size_t size = 0;
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        if (buffer.size() - size < 64) {
+            std::fwrite(buffer.data(), 1, size, out);
+            size = 0;
+        }
+        char* pos = buffer.data() + size;
+        pos = std::to_chars(pos, pos + 24, rng() % vertexesCount).ptr;
+        *pos++ = ' ';
+        pos = std::to_chars(pos, pos + 24, rng() % vertexesCount).ptr;
+        *pos++ = ' ';
+        pos = std::to_chars(pos, pos + 12, rng() % 1000).ptr;
+        *pos++ = '\n';
+        size = pos - buffer.data();
+    }
+    std::fwrite(buffer.data(), 1, size, out);
+    std::fclose(out);
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool SameGraph(const TGraph& left, const TGraph& right) {
+    if (left.Vertices.size() != right.Vertices.size() || left.Edges.size() != right.Edges.size()) {
+        return false;
+    }
+    for (std::size_t v = 0; v < left.Vertices.size(); ++v) {
+        const auto& a = left.Vertices[v].Adj;
+        const auto& b = right.Vertices[v].Adj;
+        if (a.size() != b.size() || left.Vertices[v].Value != right.Vertices[v].Value) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i].vertex != b[i].vertex || a[i].edge != b[i].edge) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Usage: ./a.out <edge list>                     - parse a file with all threads
+//        ./a.out <vertexes> <edges> [edge list]  - generate a file and compare with AddEdge
+void Benchmark(const std::string& path, bool compare) {
+    std::ifstream sizeProbe(path, std::ios::binary | std::ios::ate);
+    const double gigabytes = static_cast<double>(sizeProbe.tellg()) / (1 << 30);
+    const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    TGraph expected;
+    if (compare) {
+        double baseline = MeasureSeconds([&] { expected = LoadWithAddEdge(path); });
+        std::cout << "iostreams + AddEdge: " << baseline << "s " << gigabytes / baseline << "GB/s" << std::endl;
+    }
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    for (auto threads : threadCounts) {
+        NEdgeList::TCsrGraph csr;
+        double load = MeasureSeconds([&] { csr = NEdgeList::Load<false>(path, threads); });
+        TGraph graph;
+        double convert = MeasureSeconds([&] { graph = NEdgeList::ToGraph<TGraph>(csr, threads); });
+        std::cout << "threads:" << threads << " vertexes:" << csr.VerticesCount() << " edges:" << csr.Edges.size()
+            << " csr: " << load << "s " << gigabytes / load << "GB/s"
+            << " to TGraph: " << convert << "s"
+            << (compare && !SameGraph(graph, expected) ? " MISMATCH" : "") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2) {
+        Benchmark(argv[1], false);
+        return 0;
+    }
+    if (argc > 2) {
+        const std::string path = argc > 3 ? argv[3] : "edges.txt";
+        WriteRandomEdgeList(path, std::stoul(argv[1]), std::stoul(argv[2]), 42);
+        Benchmark(path, true);
+        return 0;
+    }
+
+    const std::string path = "example.txt";
+    std::ofstream(path) << "# u v w\n0 1 4\n1 2 8\n0 2 11\n\n2 3\n";
+    auto csr = NEdgeList::Load<false>(path, 2);
+    for (std::size_t v = 0; v < csr.VerticesCount(); ++v) {
+        std::cout << v << ":";
+        for (auto i = csr.Offsets[v]; i < csr.Offsets[v + 1]; ++i) {
+            std::cout << " " << csr.Adj[i].vertex << "(" << csr.Edges[csr.Adj[i].edge].weight << ")";
+        }
+        std::cout << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cstdint>
+
+// Seeded graph generators. Only the raw output of std::mt19937_64 is used (no std
+// distributions, whose results differ between standard libraries), so a seed gives the
+// same graph everywhere.
+namespace NGraphGen {
+
+struct TEdge {
+    std::uint32_t v1;
+    std::uint32_t v2;
+    int weight;
+};
+
+struct TEdgeList {
+    std::size_t VerticesCount = 0;
+    std::vector<TEdge> Edges;
+};
+
+class TRandom {
+public:
+    explicit TRandom(std::uint64_t seed)
+        : Engine(seed)
+    {
+    }
+
+    // Uniform in [0, bound), the modulo bias is negligible for 64-bit draws
+    std::uint64_t Below(std::uint64_t bound) {
+        return Engine() % bound;
+    }
+
+    // Uniform in [0, 1)
+    double Unit() {
+        return (Engine() >> 11) * 0x1.0p-53;
+    }
+
+    int Weight(int maxWeight) {
+        return 1 + static_cast<int>(Below(maxWeight));
+    }
+
+private:
+    std::mt19937_64 Engine;
+};
+
+// Relabels vertices by a random permutation, so ids carry no structure
+inline void ShuffleIds(TEdgeList& graph, TRandom& random) {
+    std::vector<std::uint32_t> id(graph.VerticesCount);
+    std::iota(id.begin(), id.end(), 0);
+    for (std::size_t i = id.size(); i > 1; --i) {
+        std::swap(id[i - 1], id[random.Below(i)]);
+    }
+    for (auto& edge : graph.Edges) {
+        edge.v1 = id[edge.v1];
+        edge.v2 = id[edge.v2];
+    }
+}
+
+// R-MAT / Kronecker graph with 2^scale vertices: every edge picks one quadrant of the
+// adjacency matrix per bit with probabilities a, b, c, 1 - a - b - c. Defaults are the
+// Graph500 ones, which give a skewed power law degree distribution.
+inline TEdgeList Rmat(std::size_t scale, std::size_t edgesCount, std::uint64_t seed, int maxWeight = 100,
+    double a = 0.57, double b = 0.19, double c = 0.19)
+{
+    TRandom random(seed);
+    TEdgeList graph;
+    graph.VerticesCount = std::size_t(1) << scale;
+    graph.Edges.reserve(edgesCount);
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        std::uint32_t v1 = 0;
+        std::uint32_t v2 = 0;
+        for (std::size_t bit = 0; bit < scale; ++bit) {
+            double r = random.Unit();
+            v1 = v1 * 2 + (r >= a + b);
+            v2 = v2 * 2 + ((r >= a && r < a + b) || r >= a + b + c);
+        }
+        graph.Edges.push_back(TEdge{.v1 = v1, .v2 = v2, .weight = random.Weight(maxWeight)});
+    }
+    ShuffleIds(graph, random);
+    return graph;
+}
+
+// G(n, m): m edges with uniformly random ends, self loops excluded
+inline TEdgeList ErdosRenyi(std::size_t verticesCount, std::size_t edgesCount, std::uint64_t seed, int maxWeight = 100) {
+    TRandom random(seed);
+    TEdgeList graph;
+    graph.VerticesCount = verticesCount;
+    graph.Edges.reserve(edgesCount);
+    while (graph.Edges.size() < edgesCount && verticesCount > 1) {
+        std::uint32_t v1 = random.Below(verticesCount);
+        std::uint32_t v2 = random.Below(verticesCount);
+        if (v1 != v2) {
+            graph.Edges.push_back(TEdge{.v1 = v1, .v2 = v2, .weight = random.Weight(maxWeight)});
+        }
+    }
+    return graph;
+}
+
+// Road like: rows x cols grid, every street in both directions with its own weight
+inline TEdgeList Grid(std::size_t rows, std::size_t cols, std::uint64_t seed, int maxWeight = 100) {
+    TRandom random(seed);
+    TEdgeList graph;
+    graph.VerticesCount = rows * cols;
+    graph.Edges.reserve(4 * rows * cols);
+    auto street = [&](std::uint32_t v1, std::uint32_t v2) {
+        graph.Edges.push_back(TEdge{.v1 = v1, .v2 = v2, .weight = random.Weight(maxWeight)});
+        graph.Edges.push_back(TEdge{.v1 = v2, .v2 = v1, .weight = random.Weight(maxWeight)});
+    };
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < cols; ++c) {
+            std::uint32_t v = r * cols + c;
+            if (c + 1 < cols) {
+                street(v, v + 1);
+            }
+            if (r + 1 < rows) {
+                street(v, v + cols);
+            }
+        }
+    }
+    return graph;
+}
+
+// Acyclic: every edge goes from a lower to a higher id, ids are a topological order
+inline TEdgeList Dag(std::size_t verticesCount, std::size_t edgesCount, std::uint64_t seed, int maxWeight = 100) {
+    TRandom random(seed);
+    TEdgeList graph;
+    graph.VerticesCount = verticesCount;
+    graph.Edges.reserve(edgesCount);
+    while (graph.Edges.size() < edgesCount && verticesCount > 1) {
+        std::uint32_t v1 = random.Below(verticesCount);
+        std::uint32_t v2 = random.Below(verticesCount);
+        if (v1 != v2) {
+            graph.Edges.push_back(TEdge{.v1 = std::min(v1, v2), .v2 = std::max(v1, v2), .weight = random.Weight(maxWeight)});
+        }
+    }
+    return graph;
+}
+
+// Builds any of the io3rd graph types through its own AddVertex/AddEdge
+template<typename TGraph>
+TGraph ToGraph(const TEdgeList& list) {
+    TGraph graph;
+    graph.Vertices.reserve(list.VerticesCount);
+    for (std::size_t v = 0; v < list.VerticesCount; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    if constexpr (requires { graph.Edges.reserve(0); }) {
+        graph.Edges.reserve(list.Edges.size());
+    }
+    for (const auto& edge : list.Edges) {
+        if constexpr (requires { graph.AddEdge(edge.v1, edge.v2, edge.weight); }) {
+            graph.AddEdge(edge.v1, edge.v2, edge.weight);
+        } else {
+            graph.AddEdge(edge.v1, edge.v2);
+        }
+    }
+    return graph;
+}
+
+} // namespace NGraphGen
@@ -0,0 +1,303 @@
+// Every header the algorithm sources below pull in goes first: the sources are included
+// inside namespaces, and a standard header included there for the first time would end up
+// in the wrong namespace (errors like "'array' is not a member of 'NBfs::std'").
+// Whoever adds a standard or system header to one of the included sources must add it
+// to this list as well, and build graph_benchmark.
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+#include <deque>
+#include <map>
+#include <set>
+#include <queue>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <span>
+#include <bit>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <type_traits>
+#include <assert.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+#include "graph_generators.h"
+
+// Algorithms are taken as is from their directories. Each of them has its own graph type,
+// so each lives in its own namespace, and its demo main is renamed out of the way.
+// Headers used by these sources must be in the pre-include list at the top of this file.
+#define main algorithm_main
+namespace NBfs {
+#include "../bfs/main.cpp"
+}
+namespace NDfs {
+#include "../dfs/main.cpp"
+}
+namespace NDijkstra {
+#include "../djkstra/main.cpp"
+}
+namespace NBellmanFord {
+#include "../bellman-ford/main.cpp"
+}
+namespace NJohnson {
+#include "../all_pairs_shortest_path/johson.cpp"
+}
+namespace NFloydWarshall {
+#include "../all_pairs_shortest_path/main.cpp"
+}
+namespace NPrim {
+#include "../prim/main.cpp"
+}
+namespace NKruskal {
+#include "../kruskal/main.cpp"
+}
+namespace NScc {
+#include "../strongly_connected/main.cpp"
+}
+namespace NArticulationPoints {
+#include "../articulation_points/main.cpp"
+}
+#undef main
+
+// Graph generator and benchmark suite for the graph algorithms of io3rd. Every run gets a
+// fresh process (fork), which builds its graph from a seeded generator and times one
+// algorithm, so peak RSS of a row is that of the algorithm alone plus its input graph.
+// Output is CSV on stdout:
+//
+//   algorithm,generator,vertices,edges,seconds,edges_per_sec,peak_rss_kb
+//
+// Usage: ./a.out [min log2 vertices] [max log2 vertices] [edge factor] [seed]
+
+constexpr std::uint64_t DEFAULT_SEED = 42;
+
+enum class EGenerator {
+    Rmat,
+    ErdosRenyi,
+    Grid,
+    Dag,
+};
+
+const char* ToString(EGenerator generator) {
+    switch (generator) {
+        case EGenerator::Rmat: return "rmat";
+        case EGenerator::ErdosRenyi: return "erdos_renyi";
+        case EGenerator::Grid: return "grid";
+        case EGenerator::Dag: return "dag";
+    }
+    return "unknown";
+}
+
+NGraphGen::TEdgeList Generate(EGenerator generator, std::size_t logVertices, std::size_t edgeFactor, std::uint64_t seed) {
+    const std::size_t n = std::size_t(1) << logVertices;
+    switch (generator) {
+        case EGenerator::Rmat:
+            return NGraphGen::Rmat(logVertices, n * edgeFactor, seed);
+        case EGenerator::ErdosRenyi:
+            return NGraphGen::ErdosRenyi(n, n * edgeFactor, seed);
+        case EGenerator::Grid: {
+            // 2^log as close to square as it gets, degree is fixed at 4
+            std::size_t rows = std::size_t(1) << (logVertices / 2);
+            return NGraphGen::Grid(rows, n / rows, seed);
+        }
+        case EGenerator::Dag:
+            return NGraphGen::Dag(n, n * edgeFactor, seed);
+    }
+    throw std::runtime_error("unknown generator");
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+long PeakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Keeps results alive, so the optimizer can't drop the work
+std::atomic_size_t Sink = 0;
+
+// R-MAT leaves many vertices isolated, so single source runs start at the lowest vertex with
+// an out edge: in the giant component with high probability, and the first one of the DAG
+std::uint32_t Source(const NGraphGen::TEdgeList& list) {
+    std::uint32_t source = UINT32_MAX;
+    for (const auto& edge : list.Edges) {
+        source = std::min(source, edge.v1);
+    }
+    return list.Edges.empty() ? 0 : source;
+}
+
+// Builds the algorithm's own graph type from the edge list, outside of the timed part
+using TRun = std::function<double(const NGraphGen::TEdgeList&)>;
+
+struct TAlgorithm {
+    const char* Name;
+    TRun Run;
+    // O(V^2) memory or O(VE) and worse time get a smaller size limit
+    std::size_t MaxLogVertices;
+    std::vector<EGenerator> Generators;
+};
+
+std::vector<TAlgorithm> Algorithms() {
+    using namespace NGraphGen;
+    const std::vector<EGenerator> all{EGenerator::Rmat, EGenerator::ErdosRenyi, EGenerator::Grid, EGenerator::Dag};
+    // Undirected algorithms: the DAG would be just another random graph
+    const std::vector<EGenerator> undirected{EGenerator::Rmat, EGenerator::ErdosRenyi, EGenerator::Grid};
+    std::vector<TAlgorithm> result;
+
+    result.push_back({"bfs", [](const TEdgeList& list) {
+        auto g = ToGraph<NBfs::TGraph>(list);
+        return MeasureSeconds([&] {
+            NBfs::BFS(g, Source(list), [](auto id, const auto&, auto, int distance) {
+                Sink += id + distance;
+                return true;
+            });
+        });
+    }, 24, undirected});
+
+    result.push_back({"dfs", [](const TEdgeList& list) {
+        auto g = ToGraph<NDfs::TGraph>(list);
+        struct TVisitor {
+            void Enter(NDfs::TGraph::TVertextId id, std::uint32_t) {
+                Sink += id;
+            }
+        } visitor;
+        NDfs::TDfsEngine<NDfs::TGraph> engine(g);
+        return MeasureSeconds([&] { engine.VisitAll(visitor); });
+    }, 24, undirected});
+
+    result.push_back({"dijkstra", [](const TEdgeList& list) {
+        auto g = ToGraph<NDijkstra::TGraph>(list);
+        NDijkstra::TAttrList attr;
+        return MeasureSeconds([&] {
+            NDijkstra::dag_shortest_path(g, Source(list), attr);
+            Sink += attr.back().distance;
+        });
+    }, 22, all});
+
+    result.push_back({"bellman_ford", [](const TEdgeList& list) {
+        auto g = ToGraph<NBellmanFord::TGraph>(list);
+        NBellmanFord::TAttrList attr;
+        return MeasureSeconds([&] { Sink += NBellmanFord::bellman_ford(g, Source(list), attr); });
+    }, 12, all});
+
+    result.push_back({"johnson", [](const TEdgeList& list) {
+        auto g = ToGraph<NJohnson::TGraph>(list);
+        NJohnson::TDistanceMatrix distances;
+        return MeasureSeconds([&] { Sink += NJohnson::johnson_parallel(g, distances); });
+    }, 12, all});
+
+    result.push_back({"floyd_warshall", [](const TEdgeList& list) {
+        auto g = ToGraph<NFloydWarshall::TGraph>(list);
+        return MeasureSeconds([&] { Sink += NFloydWarshall::floyd_warshall_blocked(g).size(); });
+    }, 11, all});
+
+    result.push_back({"prim", [](const TEdgeList& list) {
+        auto g = ToGraph<NPrim::TGraph>(list);
+        return MeasureSeconds([&] { Sink += NPrim::prim(g).Edges.size(); });
+    }, 22, undirected});
+
+    result.push_back({"kruskal", [](const TEdgeList& list) {
+        auto g = ToGraph<NKruskal::TGraph>(list);
+        return MeasureSeconds([&] { Sink += NKruskal::kruskal(g).Edges.size(); });
+    }, 22, undirected});
+
+    result.push_back({"scc", [](const TEdgeList& list) {
+        auto g = ToGraph<NScc::TGraph>(list);
+        return MeasureSeconds([&] { Sink += NScc::TarjanConnectedComponents(g).size(); });
+    }, 22, all});
+
+    result.push_back({"articulation_points", [](const TEdgeList& list) {
+        auto g = ToGraph<NArticulationPoints::TGraph>(list);
+        return MeasureSeconds([&] {
+            Sink += NArticulationPoints::biconnected_components(g).ArticulationPoints.size();
+        });
+    }, 22, undirected});
+
+    return result;
+}
+
+struct TMeasurement {
+    double Seconds = 0;
+    long PeakRssKb = 0;
+    std::size_t Edges = 0;
+};
+
+// Runs one measurement in a child process, results come back over a pipe
+bool MeasureInChild(const TAlgorithm& algorithm, EGenerator generator, std::size_t logVertices,
+    std::size_t edgeFactor, std::uint64_t seed, TMeasurement& measurement)
+{
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("pipe failed");
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        auto list = Generate(generator, logVertices, edgeFactor, seed);
+        TMeasurement result;
+        result.Edges = list.Edges.size();
+        result.Seconds = algorithm.Run(list);
+        result.PeakRssKb = PeakRssKb();
+        bool written = write(fds[1], &result, sizeof(result)) == sizeof(result);
+        _exit(written ? 0 : 1);
+    }
+    close(fds[1]);
+    bool read_ok = read(fds[0], &measurement, sizeof(measurement)) == sizeof(measurement);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return read_ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t minLog = argc > 1 ? std::stoul(argv[1]) : 10;
+    std::size_t maxLog = argc > 2 ? std::stoul(argv[2]) : 16;
+    std::size_t edgeFactor = argc > 3 ? std::stoul(argv[3]) : 8;
+    std::uint64_t seed = argc > 4 ? std::stoull(argv[4]) : DEFAULT_SEED;
+
+    std::cout << "algorithm,generator,vertices,edges,seconds,edges_per_sec,peak_rss_kb" << std::endl;
+    for (const auto& algorithm : Algorithms()) {
+        for (auto generator : algorithm.Generators) {
+            for (std::size_t log = minLog; log <= std::min(maxLog, algorithm.MaxLogVertices); ++log) {
+                TMeasurement measurement;
+                if (!MeasureInChild(algorithm, generator, log, edgeFactor, seed, measurement)) {
+                    std::cerr << algorithm.Name << " " << ToString(generator) << " 2^" << log << " failed" << std::endl;
+                    continue;
+                }
+                std::cout << algorithm.Name << ","
+                    << ToString(generator) << ","
+                    << (std::size_t(1) << log) << ","
+                    << measurement.Edges << ","
+                    << measurement.Seconds << ","
+                    << static_cast<std::size_t>(measurement.Edges / std::max(measurement.Seconds, 1e-9)) << ","
+                    << measurement.PeakRssKb << std::endl;
+            }
+        }
+    }
+    return 0;
+}
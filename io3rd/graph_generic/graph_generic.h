@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// TGraphGeneric with the edge weight and the vertex payload as template parameters.
+//
+// Payloads live in their own column next to Vertices, so Vertices[v] is the adjacency list
+// only and traversals never load payload bytes. With TNoPayload the column is an empty
+// specialization and takes no memory at all, with TNoWeight the weight takes no room in TEdge:
+//
+//   TGraphGeneric<true>                                  - int weights, std::string values as before
+//   TGraphGeneric<true, std::int64_t>                    - 64-bit weights
+//   TGraphGeneric<false, double>                         - floating point weights
+//   TGraphGeneric<true, TNoWeight, TNoPayload>           - pure topology
+//
+// Values are read through Value(v) instead of Vertices[v].Value.
+struct TNoPayload {
+};
+
+struct TNoWeight {
+    friend bool operator==(TNoWeight, TNoWeight) = default;
+};
+
+template<typename TPayload>
+class TPayloadColumn {
+public:
+    void Add(const TPayload& payload) {
+        Values.push_back(payload);
+    }
+
+    const TPayload& Get(std::size_t v) const {
+        return Values[v];
+    }
+
+    TPayload& Get(std::size_t v) {
+        return Values[v];
+    }
+
+    void Resize(std::size_t size) {
+        Values.resize(size);
+    }
+
+    void Reserve(std::size_t size) {
+        Values.reserve(size);
+    }
+
+    std::size_t MemoryBytes() const {
+        std::size_t result = Values.capacity() * sizeof(TPayload);
+        if constexpr (requires (const TPayload& p) { p.capacity(); }) {
+            // Heap part of strings and alike, short strings stay inside the object
+            const auto inplace = TPayload().capacity();
+            for (const auto& value : Values) {
+                if (value.capacity() > inplace) {
+                    result += value.capacity() + 1;
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<TPayload> Values;
+};
+
+template<>
+class TPayloadColumn<TNoPayload> {
+public:
+    void Add(const TNoPayload&) {
+    }
+
+    const TNoPayload& Get(std::size_t) const {
+        return Empty;
+    }
+
+    void Resize(std::size_t) {
+    }
+
+    void Reserve(std::size_t) {
+    }
+
+    std::size_t MemoryBytes() const {
+        return 0;
+    }
+
+private:
+    static constexpr TNoPayload Empty{};
+};
+
+template<bool Directed, typename TWeightType = int, typename TPayload = std::string>
+struct TGraphGeneric {
+    using TVertexValue = TPayload;
+    using TWeight = TWeightType;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        [[no_unique_address]] TWeight weight{};
+    };
+    using TEdges = std::vector<TEdge>;
+
+    TVertices Vertices;
+    TEdges Edges;
+    [[no_unique_address]] TPayloadColumn<TPayload> Payloads;
+
+    TVertextId AddVertex(const TVertexValue& v = {}) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back();
+        Payloads.Add(v);
+        return id;
+    }
+
+    void Reserve(std::size_t vertices, std::size_t edges) {
+        Vertices.reserve(vertices);
+        Payloads.Reserve(vertices);
+        Edges.reserve(edges);
+    }
+
+    // New vertices get default payloads
+    void Resize(std::size_t count) {
+        Vertices.resize(count);
+        Payloads.Resize(count);
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, TWeight weight = {}) {
+        auto edgeId = Edges.size();
+        Edges.push_back(TEdge{.v1 = v1, .v2 = v2, .weight = weight});
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge = edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge = edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+
+    const TVertexValue& Value(TVertextId v) const {
+        return Payloads.Get(v);
+    }
+
+    // Heap and object bytes of vertices, adjacency lists, edges and payloads
+    std::size_t MemoryBytes() const {
+        std::size_t result = sizeof(*this) + Vertices.capacity() * sizeof(TVertex) + Edges.capacity() * sizeof(TEdge);
+        for (const auto& vertex : Vertices) {
+            result += vertex.Adj.capacity() * sizeof(TVertextPath);
+        }
+        return result + Payloads.MemoryBytes();
+    }
+};
@@ -0,0 +1,218 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <type_traits>
+#include <fstream>
+#include <cstdio>
+
+#include "graph_generic.h"
+#include "../graph_snapshot/graph_snapshot.h"
+#include "../edge_list_loader/edge_list_loader.h"
+#include "../vertex_reordering/vertex_reordering.h"
+
+// Layout of the copies of TGraphGeneric across io3rd: payload inside TVertex, int weight
+struct TLegacyVertex {
+    std::string Value;
+    std::vector<TGraphGeneric<true>::TVertextPath> Adj;
+};
+
+struct TLegacyEdge {
+    std::size_t v1;
+    std::size_t v2;
+    int weight;
+};
+
+using TTopology = TGraphGeneric<true, TNoWeight, TNoPayload>;
+
+static_assert(sizeof(TTopology::TVertex) == sizeof(std::vector<TTopology::TVertextPath>), "vertex is just its adjacency list");
+static_assert(sizeof(TTopology::TEdge) == 2 * sizeof(std::size_t), "TNoWeight takes no room");
+static_assert(sizeof(TTopology) == 2 * sizeof(std::vector<int>), "TNoPayload column takes no room");
+
+// Single source distances for any weight type, unreachable vertices get max()
+template<typename TGraph>
+std::vector<typename TGraph::TWeight> Dijkstra(const TGraph& graph, typename TGraph::TVertextId start) {
+    using TWeight = typename TGraph::TWeight;
+    using TItem = std::pair<TWeight, typename TGraph::TVertextId>;
+    constexpr TWeight INF = std::numeric_limits<TWeight>::max();
+    std::vector<TWeight> distance(graph.Vertices.size(), INF);
+    std::priority_queue<TItem, std::vector<TItem>, std::greater<>> queue;
+    distance[start] = 0;
+    queue.push({0, start});
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        if (d > distance[v]) {
+            continue;
+        }
+        for (const auto& path : graph.Vertices[v].Adj) {
+            TWeight candidate = d + graph.Edges[path.edge].weight;
+            if (candidate < distance[path.vertex]) {
+                distance[path.vertex] = candidate;
+                queue.push({candidate, path.vertex});
+            }
+        }
+    }
+    return distance;
+}
+
+// Hop count from start, touches Vertices only
+template<typename TGraph>
+std::size_t ReachableCount(const TGraph& graph, typename TGraph::TVertextId start) {
+    std::vector<bool> seen(graph.Vertices.size(), false);
+    std::vector<typename TGraph::TVertextId> queue{start};
+    seen[start] = true;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        for (const auto& path : graph.Vertices[queue[head]].Adj) {
+            if (!seen[path.vertex]) {
+                seen[path.vertex] = true;
+                queue.push_back(path.vertex);
+            }
+        }
+    }
+    return queue.size();
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename TGraph>
+void Report(const char* name, std::size_t vertexesCount, std::size_t edgesCount, std::size_t legacyBytes) {
+    std::mt19937_64 rng(42);
+    TGraph graph;
+    graph.Reserve(vertexesCount, edgesCount);
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        if constexpr (std::is_same_v<typename TGraph::TVertexValue, std::string>) {
+            graph.AddVertex("vertex_" + std::to_string(v));
+        } else {
+            graph.AddVertex();
+        }
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        // Same draws for every weight type, so all variants get the same graph
+        auto w = 1 + rng() % 100;
+        std::size_t v1 = rng() % vertexesCount;
+        std::size_t v2 = rng() % vertexesCount;
+        typename TGraph::TWeight weight{};
+        if constexpr (std::is_arithmetic_v<typename TGraph::TWeight>) {
+            weight = w;
+        }
+        graph.AddEdge(v1, v2, weight);
+    }
+    std::size_t reached = 0;
+    double bfs = MeasureSeconds([&] { reached = ReachableCount(graph, 0); });
+    const double bytes = graph.MemoryBytes();
+    std::cout << std::left << std::setw(44) << name
+        << " vertex:" << std::setw(3) << sizeof(typename TGraph::TVertex)
+        << " + payload:" << std::setw(3) << sizeof(typename TGraph::TVertexValue) * !std::is_same_v<typename TGraph::TVertexValue, TNoPayload>
+        << " edge:" << std::setw(3) << sizeof(typename TGraph::TEdge)
+        << " total:" << std::setw(10) << bytes / vertexesCount << "B/vertex"
+        << " saved:" << std::setw(10) << (legacyBytes - bytes) / vertexesCount << "B/vertex"
+        << " bfs:" << bfs << "s reached:" << reached << std::endl;
+}
+
+// Usage: ./a.out <vertexes> <edges>
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount) {
+    // Same graph in the legacy layout, heap part of names counted like TPayloadColumn does
+    std::size_t legacyBytes = sizeof(std::vector<TLegacyVertex>) + sizeof(std::vector<TLegacyEdge>)
+        + vertexesCount * sizeof(TLegacyVertex) + edgesCount * sizeof(TLegacyEdge);
+    {
+        std::mt19937_64 rng(42);
+        std::vector<TLegacyVertex> vertices(vertexesCount);
+        for (std::size_t v = 0; v < vertexesCount; ++v) {
+            vertices[v].Value = "vertex_" + std::to_string(v);
+            if (vertices[v].Value.capacity() > std::string().capacity()) {
+                legacyBytes += vertices[v].Value.capacity() + 1;
+            }
+        }
+        for (std::size_t e = 0; e < edgesCount; ++e) {
+            rng();
+            std::size_t v1 = rng() % vertexesCount;
+            rng();
+            vertices[v1].Adj.emplace_back();
+        }
+        for (const auto& vertex : vertices) {
+            legacyBytes += vertex.Adj.capacity() * sizeof(TGraphGeneric<true>::TVertextPath);
+        }
+    }
+    std::cout << std::left << std::setw(44) << "legacy TVertex{string Value, Adj}, int"
+        << " vertex:" << std::setw(3) << sizeof(TLegacyVertex)
+        << " + payload:" << std::setw(3) << 0
+        << " edge:" << std::setw(3) << sizeof(TLegacyEdge)
+        << " total:" << std::setw(10) << double(legacyBytes) / vertexesCount << "B/vertex" << std::endl;
+
+    Report<TGraphGeneric<true>>("TGraphGeneric<true>", vertexesCount, edgesCount, legacyBytes);
+    Report<TGraphGeneric<true, std::int64_t>>("TGraphGeneric<true, int64_t>", vertexesCount, edgesCount, legacyBytes);
+    Report<TGraphGeneric<true, double, std::uint32_t>>("TGraphGeneric<true, double, uint32_t>", vertexesCount, edgesCount, legacyBytes);
+    Report<TGraphGeneric<true, float, TNoPayload>>("TGraphGeneric<true, float, TNoPayload>", vertexesCount, edgesCount, legacyBytes);
+    Report<TTopology>("TGraphGeneric<true, TNoWeight, TNoPayload>", vertexesCount, edgesCount, legacyBytes);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
+    // Weights above 2^31 and fractional ones
+    TGraphGeneric<true, std::int64_t> wide;
+    auto s = wide.AddVertex("s");
+    auto t = wide.AddVertex("t");
+    auto x = wide.AddVertex("x");
+    wide.AddEdge(s, t, 3'000'000'000);
+    wide.AddEdge(t, x, 3'000'000'000);
+    wide.AddEdge(s, x, 7'000'000'000);
+    auto wideDistance = Dijkstra(wide, s);
+    for (std::size_t v = 0; v < wide.Vertices.size(); ++v) {
+        std::cout << "int64 distance to " << wide.Value(v) << ": " << wideDistance[v] << std::endl;
+    }
+
+    TGraphGeneric<false, double, TNoPayload> road;
+    road.Resize(4);
+    road.AddEdge(0, 1, 0.5);
+    road.AddEdge(1, 2, 0.25);
+    road.AddEdge(0, 2, 1.0);
+    road.AddEdge(2, 3, 0.125);
+    auto roadDistance = Dijkstra(road, 0);
+    for (std::size_t v = 0; v < road.Vertices.size(); ++v) {
+        std::cout << "double distance to " << v << ": " << roadDistance[v] << std::endl;
+    }
+
+    // Shared headers take the templated graph too: weights keep their type in a snapshot
+    const std::string path = "graph_generic.snapshot";
+    NGraphSnapshot::Write(wide, path);
+    auto wideCopy = TGraphSnapshotGeneric<std::int64_t>(path).Materialize<TGraphGeneric<true, std::int64_t>>();
+    std::cout << "int64 snapshot: " << (Dijkstra(wideCopy, s) == wideDistance && wideCopy.Value(x) == "x" ? "same" : "MISMATCH");
+    try {
+        TGraphSnapshot narrow(path);
+        std::cout << ", opened with int weights: MISMATCH" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << ", int reader: " << e.what() << std::endl;
+    }
+    NGraphSnapshot::Write(road, path);
+    auto roadCopy = TGraphSnapshotGeneric<double>(path).Materialize<TGraphGeneric<false, double, TNoPayload>>();
+    std::cout << "double snapshot: " << (Dijkstra(roadCopy, 0) == roadDistance ? "same" : "MISMATCH") << std::endl;
+    std::remove(path.c_str());
+
+    TVertexPermutation permutation = ComputeOrder(wide, EVertexOrder::Bfs);
+    auto relabeled = Relabel(wide, permutation);
+    std::cout << "relabeled int64 graph: "
+        << (permutation.ToOld(Dijkstra(relabeled, permutation.NewId[s])) == wideDistance && relabeled.Value(permutation.NewId[x]) == "x" ? "same" : "MISMATCH")
+        << std::endl;
+
+    const std::string edgesPath = "graph_generic.edges";
+    std::ofstream(edgesPath) << "0 1 5\n1 2 7\n0 2 20\n";
+    auto loaded = NEdgeList::ToGraph<TGraphGeneric<true, double, TNoPayload>>(NEdgeList::Load<true>(edgesPath, 1), 1);
+    std::cout << "loaded edge list, double distance to 2: " << Dijkstra(loaded, 0)[2] << std::endl;
+    std::remove(edgesPath.c_str());
+    return 0;
+}
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <concepts>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary graph snapshot: a TGraphGeneric-like graph laid out as CSR in one file, so it can be
+// memory mapped back and used in place without any parsing.
+//
+//   THeader                              - magic, version, counts and section positions
+//   uint64  Offsets[V + 1]               - adjacency of v is [Offsets[v], Offsets[v + 1])
+//   uint32  Targets[A]                   - adjacency entries, A = E for directed graphs, 2E for undirected
+//   uint32  AdjEdges[A]                  - edge id of every adjacency entry
+//   uint32  Ends[2E]                     - v1, v2 of every edge
+//   TWeight Weights[E]                   - only with HasWeights, int32/int64/float/double by WeightType
+//   uint64  NameOffsets[V + 1], char[]   - vertex values, only with HasNames
+//
+// Every section starts at a multiple of SECTION_ALIGN. Numbers are stored in host byte order,
+// a snapshot written on a machine with another endianness is rejected on load.
+//
+// Both the TGraphGeneric copies of io3rd (Value inside TVertex, int weights) and the templated
+// graph of graph_generic.h (payload column, any weight type) can be written. Payloads are
+// stored as names only when they convert to std::string_view. Weights which are not
+// arithmetic (TNoWeight) give an unweighted snapshot.
+namespace NGraphSnapshot {
+
+constexpr char MAGIC[8] = {'I', 'O', '3', 'G', 'R', 'A', 'P', 'H'};
+// Version 1 had int32 weights only and zero in place of WeightType, it is read as is
+constexpr std::uint32_t VERSION = 2;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr std::uint64_t SECTION_ALIGN = 64;
+
+enum EFlags : std::uint32_t {
+    HasWeights = 1,
+    HasNames = 2,
+};
+
+enum class EWeightType : std::uint32_t {
+    Int32 = 0,
+    Int64 = 1,
+    Float32 = 2,
+    Float64 = 3,
+};
+
+inline std::uint64_t WeightBytes(EWeightType type) {
+    return type == EWeightType::Int64 || type == EWeightType::Float64 ? 8 : 4;
+}
+
+inline std::string ToString(EWeightType type) {
+    switch (type) {
+        case EWeightType::Int32: return "int32";
+        case EWeightType::Int64: return "int64";
+        case EWeightType::Float32: return "float";
+        case EWeightType::Float64: return "double";
+    }
+    return "unknown (" + std::to_string(static_cast<std::uint32_t>(type)) + ")";
+}
+
+// Open checks. Header checks the header against the file size, O(1), and leaves the data untouched,
+// so only trusted files (written by this process or by our own tools) may be opened with it:
+// Neighbours, AdjEdges, Edge and Name read offsets and ids from the file without bounds checks.
+// Full also walks every section once: offsets are non-decreasing, targets and edge ends are
+// vertex ids, adjacency edge ids are edge ids, name offsets are in order and inside the names.
+enum class EValidation {
+    Header,
+    Full,
+};
+
+template<typename TWeight>
+constexpr EWeightType WeightTypeOf() {
+    if constexpr (std::is_same_v<TWeight, std::int32_t>) {
+        return EWeightType::Int32;
+    } else if constexpr (std::is_same_v<TWeight, std::int64_t>) {
+        return EWeightType::Int64;
+    } else if constexpr (std::is_same_v<TWeight, float>) {
+        return EWeightType::Float32;
+    } else {
+        static_assert(std::is_same_v<TWeight, double>, "snapshot weights are int32, int64, float or double");
+        return EWeightType::Float64;
+    }
+}
+
+// Edges with an arithmetic weight member, TNoWeight and edges without weight are unweighted
+template<typename TEdge>
+constexpr bool IsWeighted = requires { requires std::is_arithmetic_v<decltype(TEdge::weight)>; };
+
+// Value of v: TVertex::Value in the io3rd copies, the payload column in graph_generic.h
+template<typename TGraph>
+decltype(auto) VertexValue(const TGraph& graph, std::size_t v) {
+    if constexpr (requires { graph.Value(v); }) {
+        return graph.Value(v);
+    } else {
+        return (graph.Vertices[v].Value);
+    }
+}
+
+template<typename TGraph>
+constexpr bool HasNamedVertices = requires(const TGraph& graph) {
+    { VertexValue(graph, 0) } -> std::convertible_to<std::string_view>;
+};
+
+struct THeader {
+    char Magic[8];
+    std::uint32_t Version;
+    std::uint32_t ByteOrder;
+    std::uint32_t Flags;
+    EWeightType WeightType;
+    std::uint64_t VerticesCount;
+    std::uint64_t EdgesCount;
+    std::uint64_t AdjCount;
+    std::uint64_t NamesSize;
+    std::uint64_t OffsetsPos;
+    std::uint64_t TargetsPos;
+    std::uint64_t AdjEdgesPos;
+    std::uint64_t EndsPos;
+    std::uint64_t WeightsPos;
+    std::uint64_t NameOffsetsPos;
+    std::uint64_t NamesPos;
+    std::uint64_t FileSize;
+};
+
+inline std::uint64_t AlignUp(std::uint64_t pos) {
+    return (pos + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+// Computes section positions from the counts and flags already set in header
+inline void Layout(THeader& header) {
+    const std::uint64_t n = header.VerticesCount;
+    std::uint64_t pos = AlignUp(sizeof(THeader));
+    auto place = [&pos](std::uint64_t bytes) {
+        std::uint64_t start = pos;
+        pos = AlignUp(pos + bytes);
+        return start;
+    };
+    header.OffsetsPos = place((n + 1) * sizeof(std::uint64_t));
+    header.TargetsPos = place(header.AdjCount * sizeof(std::uint32_t));
+    header.AdjEdgesPos = place(header.AdjCount * sizeof(std::uint32_t));
+    header.EndsPos = place(header.EdgesCount * 2 * sizeof(std::uint32_t));
+    header.WeightsPos = place(header.Flags & HasWeights ? header.EdgesCount * WeightBytes(header.WeightType) : 0);
+    header.NameOffsetsPos = place(header.Flags & HasNames ? (n + 1) * sizeof(std::uint64_t) : 0);
+    header.NamesPos = place(header.NamesSize);
+    header.FileSize = pos;
+}
+
+template<typename TGraph>
+void Write(const TGraph& graph, const std::string& path, bool withNames = true) {
+    using TEdge = typename TGraph::TEdge;
+    constexpr bool weighted = IsWeighted<TEdge>;
+    withNames = withNames && HasNamedVertices<TGraph>;
+    auto name = [&graph](std::uint64_t v) -> std::string_view {
+        if constexpr (HasNamedVertices<TGraph>) {
+            return VertexValue(graph, v);
+        } else {
+            return {};
+        }
+    };
+
+    const std::uint64_t n = graph.Vertices.size();
+    THeader header{};
+    std::memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+    header.Version = VERSION;
+    header.ByteOrder = BYTE_ORDER_MARK;
+    header.Flags = (weighted ? std::uint32_t(HasWeights) : 0u) | (withNames ? std::uint32_t(HasNames) : 0u);
+    if constexpr (weighted) {
+        header.WeightType = WeightTypeOf<decltype(TEdge::weight)>();
+    }
+    header.VerticesCount = n;
+    header.EdgesCount = graph.Edges.size();
+
+    std::vector<std::uint64_t> offsets(n + 1, 0);
+    std::vector<std::uint64_t> nameOffsets(withNames ? n + 1 : 0, 0);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        offsets[v + 1] = offsets[v] + graph.Vertices[v].Adj.size();
+        if (withNames) {
+            nameOffsets[v + 1] = nameOffsets[v] + name(v).size();
+        }
+    }
+    header.AdjCount = offsets[n];
+    header.NamesSize = withNames ? nameOffsets[n] : 0;
+    if (n >= UINT32_MAX || header.EdgesCount >= UINT32_MAX) {
+        throw std::length_error("graph is too big for 32-bit vertex and edge ids");
+    }
+    Layout(header);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("can't open " + path + " for writing");
+    }
+    std::uint64_t written = 0;
+    auto seek = [&](std::uint64_t pos) {
+        static const char zeros[SECTION_ALIGN] = {};
+        out.write(zeros, pos - written);
+        written = pos;
+    };
+    auto put = [&](const void* data, std::uint64_t bytes) {
+        out.write(static_cast<const char*>(data), bytes);
+        written += bytes;
+    };
+    // Sections are streamed through a small buffer instead of being copied as a whole
+    std::vector<std::uint32_t> buffer;
+    auto flush = [&](bool force) {
+        if (buffer.size() >= (1 << 16) || (force && !buffer.empty())) {
+            put(buffer.data(), buffer.size() * sizeof(std::uint32_t));
+            buffer.clear();
+        }
+    };
+
+    put(&header, sizeof(header));
+    seek(header.OffsetsPos);
+    put(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+
+    seek(header.TargetsPos);
+    for (const auto& vertex : graph.Vertices) {
+        for (const auto& adj : vertex.Adj) {
+            buffer.push_back(adj.vertex);
+            flush(false);
+        }
+    }
+    flush(true);
+
+    seek(header.AdjEdgesPos);
+    for (const auto& vertex : graph.Vertices) {
+        for (const auto& adj : vertex.Adj) {
+            buffer.push_back(adj.edge);
+            flush(false);
+        }
+    }
+    flush(true);
+
+    seek(header.EndsPos);
+    for (const auto& edge : graph.Edges) {
+        buffer.push_back(edge.v1);
+        buffer.push_back(edge.v2);
+        flush(false);
+    }
+    flush(true);
+
+    if constexpr (weighted) {
+        // Weights keep their own type and width
+        std::vector<decltype(TEdge::weight)> weights;
+        weights.reserve(1 << 16);
+        seek(header.WeightsPos);
+        for (const auto& edge : graph.Edges) {
+            weights.push_back(edge.weight);
+            if (weights.size() == weights.capacity()) {
+                put(weights.data(), weights.size() * sizeof(weights[0]));
+                weights.clear();
+            }
+        }
+        put(weights.data(), weights.size() * sizeof(weights[0]));
+    }
+
+    if (withNames) {
+        seek(header.NameOffsetsPos);
+        put(nameOffsets.data(), nameOffsets.size() * sizeof(std::uint64_t));
+        seek(header.NamesPos);
+        for (std::uint64_t v = 0; v < n; ++v) {
+            put(name(v).data(), name(v).size());
+        }
+    }
+    seek(header.FileSize);
+    if (!out.flush()) {
+        throw std::runtime_error("can't write " + path);
+    }
+}
+
+} // namespace NGraphSnapshot
+
+// Read only view of a mapped snapshot. Vertices[v].Adj is a span of target ids, so code written
+// against TGraphGeneric adjacency (BFS, TDfsEngine, ...) runs over the mapping as is.
+// TWeightType must be the weight type the snapshot was written with, a weighted snapshot of
+// another type is rejected on open. Unweighted snapshots open with any, every weight is 1.
+template<typename TWeightType = int>
+class TGraphSnapshotGeneric {
+public:
+    using TVertextId = std::uint32_t;
+    using TEdgeId = std::uint32_t;
+    using TWeight = TWeightType;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        TWeight weight;
+    };
+
+    struct TVertex {
+        std::span<const TVertextId> Adj;
+    };
+
+    struct TVerticesView {
+        const TGraphSnapshotGeneric* Snapshot;
+
+        TVertex operator[](TVertextId v) const {
+            return TVertex{.Adj = Snapshot->Neighbours(v)};
+        }
+
+        std::size_t size() const {
+            return Snapshot->Header().VerticesCount;
+        }
+    };
+
+    // Header validation maps lazily, Full touches every page once, see EValidation
+    explicit TGraphSnapshotGeneric(const std::string& path, NGraphSnapshot::EValidation validation = NGraphSnapshot::EValidation::Header) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("can't open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(NGraphSnapshot::THeader))) {
+            ::close(fd);
+            throw std::runtime_error(path + " is not a graph snapshot");
+        }
+        Size = st.st_size;
+        void* data = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("can't map " + path);
+        }
+        Data = static_cast<const char*>(data);
+        try {
+            Validate(validation);
+        } catch (...) {
+            ::munmap(const_cast<char*>(Data), Size);
+            throw;
+        }
+        Vertices = TVerticesView{this};
+    }
+
+    TGraphSnapshotGeneric(const TGraphSnapshotGeneric&) = delete;
+    TGraphSnapshotGeneric& operator=(const TGraphSnapshotGeneric&) = delete;
+
+    ~TGraphSnapshotGeneric() {
+        ::munmap(const_cast<char*>(Data), Size);
+    }
+
+    const NGraphSnapshot::THeader& Header() const {
+        return *reinterpret_cast<const NGraphSnapshot::THeader*>(Data);
+    }
+
+    std::size_t VerticesCount() const {
+        return Header().VerticesCount;
+    }
+
+    std::size_t EdgesCount() const {
+        return Header().EdgesCount;
+    }
+
+    std::span<const TVertextId> Neighbours(TVertextId v) const {
+        const auto* offsets = Section<std::uint64_t>(Header().OffsetsPos);
+        return {Section<TVertextId>(Header().TargetsPos) + offsets[v], offsets[v + 1] - offsets[v]};
+    }
+
+    // Edge ids parallel to Neighbours(v)
+    std::span<const TEdgeId> AdjEdges(TVertextId v) const {
+        const auto* offsets = Section<std::uint64_t>(Header().OffsetsPos);
+        return {Section<TEdgeId>(Header().AdjEdgesPos) + offsets[v], offsets[v + 1] - offsets[v]};
+    }
+
+    TEdge Edge(TEdgeId e) const {
+        const auto* ends = Section<TVertextId>(Header().EndsPos);
+        return TEdge{.v1 = ends[2 * e], .v2 = ends[2 * e + 1], .weight = Weight(e)};
+    }
+
+    TWeight Weight(TEdgeId e) const {
+        return Header().Flags & NGraphSnapshot::HasWeights ? Section<TWeight>(Header().WeightsPos)[e] : TWeight(1);
+    }
+
+    std::string_view Name(TVertextId v) const {
+        if (!(Header().Flags & NGraphSnapshot::HasNames)) {
+            return {};
+        }
+        const auto* offsets = Section<std::uint64_t>(Header().NameOffsetsPos);
+        return {Section<char>(Header().NamesPos) + offsets[v], offsets[v + 1] - offsets[v]};
+    }
+
+    // Copies the snapshot into a TGraphGeneric-like graph, adjacency is filled in bulk without AddEdge.
+    // Names become values of string-like payloads, other payloads are default constructed.
+    template<typename TGraph>
+    TGraph Materialize() const {
+        using TVertexValue = typename TGraph::TVertexValue;
+        using TGraphEdge = typename TGraph::TEdge;
+        TGraph graph;
+        graph.Vertices.reserve(VerticesCount());
+        graph.Edges.reserve(EdgesCount());
+        for (TEdgeId e = 0; e < EdgesCount(); ++e) {
+            auto edge = Edge(e);
+            if constexpr (NGraphSnapshot::IsWeighted<TGraphEdge>) {
+                graph.Edges.push_back({edge.v1, edge.v2, static_cast<decltype(TGraphEdge::weight)>(edge.weight)});
+            } else {
+                graph.Edges.push_back({edge.v1, edge.v2});
+            }
+        }
+        for (TVertextId v = 0; v < VerticesCount(); ++v) {
+            if constexpr (std::is_constructible_v<TVertexValue, std::string_view>) {
+                graph.AddVertex(TVertexValue(Name(v)));
+            } else {
+                graph.AddVertex(TVertexValue{});
+            }
+            auto& vertex = graph.Vertices.back();
+            auto targets = Neighbours(v);
+            auto edges = AdjEdges(v);
+            vertex.Adj.resize(targets.size());
+            for (std::size_t i = 0; i < targets.size(); ++i) {
+                vertex.Adj[i].vertex = targets[i];
+                vertex.Adj[i].edge = edges[i];
+            }
+        }
+        return graph;
+    }
+
+    TVerticesView Vertices{nullptr};
+
+private:
+    template<typename T>
+    const T* Section(std::uint64_t pos) const {
+        return reinterpret_cast<const T*>(Data + pos);
+    }
+
+    void Validate(NGraphSnapshot::EValidation validation) const {
+        using namespace NGraphSnapshot;
+        const auto& header = Header();
+        if (std::memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("not a graph snapshot");
+        }
+        if (header.Version != VERSION && header.Version != 1) {
+            throw std::runtime_error("unsupported graph snapshot version " + std::to_string(header.Version));
+        }
+        if (header.ByteOrder != BYTE_ORDER_MARK) {
+            throw std::runtime_error("graph snapshot was written with another byte order");
+        }
+        // Positions must be exactly the ones writer computes, so no section points outside of the file
+        THeader expected = header;
+        Layout(expected);
+        if (std::memcmp(&expected, &header, sizeof(header)) != 0 || header.FileSize != Size) {
+            throw std::runtime_error("corrupted graph snapshot header");
+        }
+        const auto* offsets = Section<std::uint64_t>(header.OffsetsPos);
+        if (offsets[0] != 0 || offsets[header.VerticesCount] != header.AdjCount) {
+            throw std::runtime_error("corrupted graph snapshot offsets");
+        }
+        if ((header.Flags & HasWeights) && header.WeightType != WeightTypeOf<TWeight>()) {
+            throw std::runtime_error("graph snapshot has " + ToString(header.WeightType)
+                + " weights, reader expects " + ToString(WeightTypeOf<TWeight>()));
+        }
+        if (validation == EValidation::Full) {
+            ValidateData();
+        }
+    }
+
+    void ValidateData() const {
+        const auto& header = Header();
+        const std::uint64_t n = header.VerticesCount;
+        const auto* offsets = Section<std::uint64_t>(header.OffsetsPos);
+        for (std::uint64_t v = 0; v < n; ++v) {
+            if (offsets[v] > offsets[v + 1]) {
+                throw std::runtime_error("corrupted graph snapshot: offsets of vertex " + std::to_string(v) + " are out of order");
+            }
+        }
+        const auto* targets = Section<TVertextId>(header.TargetsPos);
+        const auto* adjEdges = Section<TEdgeId>(header.AdjEdgesPos);
+        for (std::uint64_t i = 0; i < header.AdjCount; ++i) {
+            if (targets[i] >= n || adjEdges[i] >= header.EdgesCount) {
+                throw std::runtime_error("corrupted graph snapshot: adjacency entry " + std::to_string(i) + " is out of range");
+            }
+        }
+        const auto* ends = Section<TVertextId>(header.EndsPos);
+        for (std::uint64_t i = 0; i < 2 * header.EdgesCount; ++i) {
+            if (ends[i] >= n) {
+                throw std::runtime_error("corrupted graph snapshot: edge " + std::to_string(i / 2) + " is out of range");
+            }
+        }
+        if (header.Flags & NGraphSnapshot::HasNames) {
+            const auto* nameOffsets = Section<std::uint64_t>(header.NameOffsetsPos);
+            if (nameOffsets[0] != 0 || nameOffsets[n] != header.NamesSize) {
+                throw std::runtime_error("corrupted graph snapshot name offsets");
+            }
+            for (std::uint64_t v = 0; v < n; ++v) {
+                if (nameOffsets[v] > nameOffsets[v + 1]) {
+                    throw std::runtime_error("corrupted graph snapshot: name offsets of vertex " + std::to_string(v) + " are out of order");
+                }
+            }
+        }
+    }
+
+    const char* Data = nullptr;
+    std::size_t Size = 0;
+};
+
+using TGraphSnapshot = TGraphSnapshotGeneric<>;
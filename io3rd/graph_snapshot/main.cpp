@@ -0,0 +1,197 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <cstdio>
+
+#include "graph_snapshot.h"
+
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        int weight;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, int weight) {
+        auto edgeId = Edges.size();
+        Edges.emplace_back(v1, v2, weight);
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge=edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge=edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+};
+
+
+using TGraph = TGraphGeneric<false>;
+
+// Works over anything with Vertices[v].Adj, both TGraph and a mapped TGraphSnapshot
+template<typename TAdj>
+std::size_t AdjTarget(const TAdj& adj) {
+    if constexpr (requires { adj.vertex; }) {
+        return adj.vertex;
+    } else {
+        return adj;
+    }
+}
+
+template<typename TAnyGraph>
+std::vector<int> BFSDistances(const TAnyGraph& graph, std::size_t start) {
+    std::vector<int> distance(graph.Vertices.size(), -1);
+    std::vector<std::size_t> queue{start};
+    distance[start] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        auto current = queue[head];
+        for (const auto& adj : graph.Vertices[current].Adj) {
+            auto v = AdjTarget(adj);
+            if (distance[v] < 0) {
+                distance[v] = distance[current] + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+    return distance;
+}
+
+TGraph MakeRandomGraph(std::size_t vertexesCount, std::size_t edgesCount, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    TGraph graph;
+    for (std::size_t v = 0; v < vertexesCount; ++v) {
+        graph.AddVertex("v" + std::to_string(v));
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        graph.AddEdge(rng() % vertexesCount, rng() % vertexesCount, rng() % 1000);
+    }
+    return graph;
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges> [snapshot path]
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount, const std::string& path) {
+    TGraph graph;
+    double build = MeasureSeconds([&] { graph = MakeRandomGraph(vertexesCount, edgesCount, 42); });
+    double write = MeasureSeconds([&] { NGraphSnapshot::Write(graph, path); });
+
+    std::vector<int> expected;
+    double bfsGraph = MeasureSeconds([&] { expected = BFSDistances(graph, 0); });
+
+    // Mapping itself does not touch the data, first BFS over it pays for page faults
+    std::vector<int> distances;
+    double load = 0;
+    double bfsSnapshot = 0;
+    std::size_t fileSize = 0;
+    {
+        double map = MeasureSeconds([&] {
+            TGraphSnapshot snapshot(path);
+            fileSize = snapshot.Header().FileSize;
+            bfsSnapshot = MeasureSeconds([&] { distances = BFSDistances(snapshot, 0); });
+        });
+        load = map - bfsSnapshot;
+    }
+    double checked = MeasureSeconds([&] { TGraphSnapshot(path, NGraphSnapshot::EValidation::Full); });
+    TGraph copy;
+    double materialize = MeasureSeconds([&] { copy = TGraphSnapshot(path).Materialize<TGraph>(); });
+
+    bool same = distances == expected && copy.Edges.size() == graph.Edges.size()
+        && BFSDistances(copy, 0) == expected && copy.Vertices.back().Value == graph.Vertices.back().Value;
+    std::cout << "vertexes:" << vertexesCount << " edges:" << edgesCount << " file:" << (fileSize >> 20) << "MB" << std::endl
+        << "    build by AddVertex/AddEdge: " << build << "s write snapshot: " << write << "s" << std::endl
+        << "    mmap load: " << load << "s with full validation: " << checked << "s materialize TGraph: " << materialize << "s" << std::endl
+        << "    bfs over TGraph: " << bfsGraph << "s over mapping: " << bfsSnapshot << "s"
+        << (same ? "" : " MISMATCH") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]), argc > 3 ? argv[3] : "graph.snapshot");
+        return 0;
+    }
+
+    TGraph graph;
+    auto a = graph.AddVertex("a");
+    auto b = graph.AddVertex("b");
+    auto c = graph.AddVertex("c");
+    auto d = graph.AddVertex("d");
+    graph.AddEdge(a, b, 4);
+    graph.AddEdge(b, c, 8);
+    graph.AddEdge(a, c, 11);
+    graph.AddEdge(c, d, 2);
+
+    const std::string path = "example.snapshot";
+    NGraphSnapshot::Write(graph, path);
+    TGraphSnapshot snapshot(path);
+    for (TGraphSnapshot::TVertextId v = 0; v < snapshot.VerticesCount(); ++v) {
+        std::cout << snapshot.Name(v) << ":";
+        auto edges = snapshot.AdjEdges(v);
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            std::cout << " " << snapshot.Name(snapshot.Neighbours(v)[i]) << "(" << snapshot.Weight(edges[i]) << ")";
+        }
+        std::cout << std::endl;
+    }
+    auto distances = BFSDistances(snapshot, a);
+    std::cout << "hops from a to d: " << distances[d] << std::endl;
+
+    // Target of the first adjacency entry is overwritten with an id past the last vertex
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const std::uint32_t bad = 1000;
+        file.seekp(snapshot.Header().TargetsPos);
+        file.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+    }
+    TGraphSnapshot unchecked(path);
+    std::cout << "corrupted target, header validation opens it: " << unchecked.Neighbours(a)[0] << std::endl;
+    try {
+        TGraphSnapshot checked(path, NGraphSnapshot::EValidation::Full);
+        std::cout << "full validation: MISSED" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "full validation: " << e.what() << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,492 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <numeric>
+#include <string>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+template<typename T>
+struct TDSPrototype {
+    T* Parent = nullptr;
+    int Rank = 0;
+};
+
+
+template<typename TNode>
+struct TDisjointSet { 
+    
+    void MakeSet(TNode* node) {
+        node->ds.Parent = node;
+        node->ds.Rank = 0;
+    }
+    
+    void MakeSet(TNode& node) {
+        MakeSet(&node);
+    }
+
+    TNode* FindSet(TNode* node) {
+        TNode* theParent = node;
+        // Find representative of the set (father of fathers)
+        while (theParent->ds.Parent != theParent) {
+            theParent = theParent->ds.Parent;
+        }
+        // Path compression for nodes
+        while (node != theParent) {
+            auto* tmp = node;
+            node = node->ds.Parent;
+            tmp->ds.Parent = theParent;
+        }
+        return theParent;
+    }
+
+    bool IsSameSet(TNode* node1, TNode* node2) {
+        return FindSet(node1) == FindSet(node2); 
+    }
+
+    bool IsSameSet(TNode& node1, TNode& node2) {
+        return IsSameSet(&node1, &node2);
+    }
+
+    bool Union(TNode* x,  TNode* y) {
+        return Link(FindSet(x), FindSet(y));
+    }
+    
+    bool Union(TNode& x,  TNode& y) {
+        return Union(&x, &y);
+    }
+
+private:
+    bool Link(TNode* x,  TNode* y) {
+        if (x == y) {
+            return false;
+        } 
+        if (x->ds.Rank > y->ds.Rank) {
+            y->ds.Parent = x;
+        } else {
+            x->ds.Parent = y;
+        }
+        if (x->ds.Rank == y->ds.Rank) {
+            y->ds.Rank += 1; 
+        }
+        return true;
+    }
+};
+
+template<typename TNode>
+struct TDisjointSetBuff : public TDisjointSet<TNode> {
+    using TParent = TDisjointSet<TNode>;
+    
+    explicit TDisjointSetBuff(std::size_t size) {
+        Buffer.resize(size);
+        for (auto& b : Buffer) {
+            TParent::MakeSet(b);
+        }
+    }
+
+    TNode& Get(std::size_t v) {
+        return Buffer[v];
+    }
+
+    bool Union(std::size_t v1, std::size_t v2) {
+        return TParent::Union(Get(v1), Get(v2));
+    }
+
+    bool IsSameSet(std::size_t v1, std::size_t v2) {
+        return TParent::IsSameSet(Get(v1), Get(v2));
+    }
+
+    TNode* FindSet(std::size_t v) {
+        return TParent::FindSet(&Get(v));
+    }
+
+private:
+    std::vector<TNode> Buffer;
+};
+
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        int weight;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, int weight) {
+        auto edgeId = Edges.size();
+        Edges.emplace_back(v1, v2, weight);
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge=edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge=edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+};
+
+using TGraph = TGraphGeneric<false>;
+
+TGraph kruskal(const TGraph& graph) {
+    struct TAttr {
+        TDSPrototype<TAttr> ds;
+    };
+
+    // Init disjoint set data structure
+    TDisjointSetBuff<TAttr> disjointSet{ graph.Vertices.size() };
+
+    // Prepare resulting graph (tree)
+    TGraph result;
+    result.Vertices.reserve(graph.Vertices.size());
+    for(auto& v : graph.Vertices) {
+        result.AddVertex(v.Value);
+    }
+
+    // Sort edges by weight asc
+    auto edges = graph.Edges;
+    std::sort(edges.begin(), edges.end(), [](const TGraph::TEdge& e1, const TGraph::TEdge& e2) {
+        return e1.weight < e2.weight;
+    });
+
+    // body of the algo
+    for (const auto& e : edges) {
+        if (disjointSet.IsSameSet(e.v1, e.v2)) {
+            continue;
+        }
+        disjointSet.Union(e.v1, e.v2);
+        result.AddEdge(e);
+    }
+
+    return result;
+}
+
+TGraph prim(const TGraph& graph) {
+    struct TAttr {
+        bool visited = false;
+    };
+
+    std::vector<TAttr> attr;
+    attr.resize(graph.Vertices.size());
+    
+
+    auto compare = [&graph](const TGraph::TVertextPath& l, const TGraph::TVertextPath& r) {
+        return graph.Edges[l.edge].weight > graph.Edges[r.edge].weight;
+    };
+    std::priority_queue<TGraph::TVertextPath, std::vector<TGraph::TVertextPath>, decltype(compare)> pq(compare);
+    auto add_vertex = [&](TGraph::TVertextId id) {
+        attr[id].visited = true;
+        for (auto& path : graph.Vertices[id].Adj) {
+            if (!attr[path.vertex].visited) {
+                pq.push(path);
+            }
+        }
+    };
+    // Prepare resulting graph (tree)
+    TGraph result;
+    result.Vertices.reserve(graph.Vertices.size());
+    for (auto& v : graph.Vertices) {
+        result.AddVertex(v.Value);
+    }
+    // init
+    add_vertex(0);
+
+    while (!pq.empty())
+    {
+        auto path = pq.top();
+        pq.pop();
+        if (attr[path.vertex].visited) {
+            continue;
+        }
+        result.AddEdge(graph.Edges[path.edge]);
+        add_vertex(path.vertex);
+    }
+    // std::priority
+    return result;
+}
+
+
+// Runs func(begin, end) over count items split into equal contiguous chunks, one per thread
+template<typename TFunc>
+void parallel_chunks(std::size_t count, std::size_t threads_count, TFunc&& func) {
+    threads_count = std::max<std::size_t>(1, std::min(threads_count, count));
+    if (threads_count == 1) {
+        func(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threads_count; ++t) {
+        std::size_t begin = count * t / threads_count;
+        std::size_t end = count * (t + 1) / threads_count;
+        threads.emplace_back([&func, begin, end, t] { func(begin, end, t); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// Parallel Boruvka. Every round each component picks its lightest crossing edge,
+// components are hooked along those edges, and edges which became internal to a
+// component are filtered out, so later rounds only scan edges which can still be in the tree.
+//
+// Ties are broken by edge id: (weight, id) keys are unique, so hooks never form cycles
+// longer than two (both sides of the same edge), and those are broken by vertex id.
+std::vector<TGraph::TEdgeId> boruvka_mst(const TGraph& graph, std::size_t threads_count = std::thread::hardware_concurrency()) {
+    using TComponentId = std::uint32_t;
+    using TKey = std::uint64_t;
+    constexpr TKey NO_EDGE = std::numeric_limits<TKey>::max();
+    // hardware_concurrency() may be 0, the per thread buffers need at least one slot
+    threads_count = std::max<std::size_t>(1, threads_count);
+
+    const std::size_t n = graph.Vertices.size();
+    if (n >= std::numeric_limits<TComponentId>::max() || graph.Edges.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Graph is too big for 32 bit ids");
+    }
+    auto make_key = [&graph](TGraph::TEdgeId id) {
+        // flip sign bit so unsigned order of weights matches signed one
+        auto weight = static_cast<std::uint32_t>(graph.Edges[id].weight) ^ 0x8000'0000u;
+        return (TKey(weight) << 32) | TKey(id);
+    };
+
+    // component[v] is always the root of v after a round
+    std::vector<TComponentId> component(n);
+    std::iota(component.begin(), component.end(), 0);
+    std::vector<TComponentId> hook(n);
+    std::vector<std::atomic<TKey>> best(n);
+
+    std::vector<std::uint32_t> alive(graph.Edges.size());
+    std::iota(alive.begin(), alive.end(), 0);
+    std::vector<std::vector<std::uint32_t>> kept(threads_count);
+    std::vector<std::vector<TGraph::TEdgeId>> picked(threads_count);
+    std::vector<TGraph::TEdgeId> result;
+
+    while (!alive.empty()) {
+        parallel_chunks(n, threads_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                best[v].store(NO_EDGE, std::memory_order_relaxed);
+            }
+        });
+
+        // 1. Lightest crossing edge per component
+        auto atomic_min = [](std::atomic<TKey>& target, TKey key) {
+            TKey current = target.load(std::memory_order_relaxed);
+            while (key < current && !target.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+            }
+        };
+        parallel_chunks(alive.size(), threads_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const auto& e = graph.Edges[alive[i]];
+                auto c1 = component[e.v1];
+                auto c2 = component[e.v2];
+                if (c1 == c2) {
+                    // self loop, filtered out after the first round
+                    continue;
+                }
+                auto key = make_key(alive[i]);
+                atomic_min(best[c1], key);
+                atomic_min(best[c2], key);
+            }
+        });
+
+        // 2. Hook every component to the one across its lightest edge
+        parallel_chunks(n, threads_count, [&](std::size_t begin, std::size_t end, std::size_t t) {
+            for (std::size_t c = begin; c < end; ++c) {
+                hook[c] = c;
+                TKey key = best[c].load(std::memory_order_relaxed);
+                if (component[c] != c || key == NO_EDGE) {
+                    continue;
+                }
+                const auto& e = graph.Edges[key & 0xFFFF'FFFFu];
+                TComponentId other = component[e.v1] == c ? component[e.v2] : component[e.v1];
+                if (best[other].load(std::memory_order_relaxed) == key && c < other) {
+                    // Both components picked the same edge: the smaller one stays the root
+                    continue;
+                }
+                hook[c] = other;
+                picked[t].push_back(key & 0xFFFF'FFFFu);
+            }
+        });
+
+        // 3. Pointer jumping until every hook points to a root
+        bool changed = true;
+        while (changed) {
+            std::atomic_bool any = false;
+            parallel_chunks(n, threads_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+                bool local = false;
+                for (std::size_t c = begin; c < end; ++c) {
+                    std::atomic_ref<TComponentId> parent(hook[c]);
+                    auto p = parent.load(std::memory_order_relaxed);
+                    auto pp = std::atomic_ref<TComponentId>(hook[p]).load(std::memory_order_relaxed);
+                    if (p != pp) {
+                        parent.store(pp, std::memory_order_relaxed);
+                        local = true;
+                    }
+                }
+                if (local) {
+                    any = true;
+                }
+            });
+            changed = any;
+        }
+
+        // 4. Relabel vertices and drop edges inside components
+        parallel_chunks(n, threads_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                component[v] = hook[component[v]];
+            }
+        });
+        parallel_chunks(alive.size(), threads_count, [&](std::size_t begin, std::size_t end, std::size_t t) {
+            kept[t].clear();
+            for (std::size_t i = begin; i < end; ++i) {
+                const auto& e = graph.Edges[alive[i]];
+                if (component[e.v1] != component[e.v2]) {
+                    kept[t].push_back(alive[i]);
+                }
+            }
+        });
+        alive.clear();
+        for (auto& k : kept) {
+            alive.insert(alive.end(), k.begin(), k.end());
+            k.clear();
+        }
+        for (auto& p : picked) {
+            result.insert(result.end(), p.begin(), p.end());
+            p.clear();
+        }
+    }
+    return result;
+}
+
+TGraph boruvka(const TGraph& graph) {
+    TGraph result;
+    result.Vertices.reserve(graph.Vertices.size());
+    for (auto& v : graph.Vertices) {
+        result.AddVertex(v.Value);
+    }
+    for (auto id : boruvka_mst(graph)) {
+        result.AddEdge(graph.Edges[id]);
+    }
+    return result;
+}
+
+// Connected random graph: a random spanning tree plus uniformly random edges
+TGraph make_random_graph(std::size_t vertexes_count, std::size_t edges_count, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 1'000'000);
+    TGraph graph;
+    graph.Vertices.reserve(vertexes_count);
+    graph.Edges.reserve(edges_count);
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t v = 1; v < vertexes_count; ++v) {
+        graph.AddEdge(v, rng() % v, weight(rng));
+    }
+    while (graph.Edges.size() < edges_count) {
+        graph.AddEdge(rng() % vertexes_count, rng() % vertexes_count, weight(rng));
+    }
+    return graph;
+}
+
+long long total_weight(const TGraph& tree) {
+    long long result = 0;
+    for (const auto& e : tree.Edges) {
+        result += e.weight;
+    }
+    return result;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges>, e.g. ./a.out 10000000 100000000
+void benchmark_mst(std::size_t vertexes_count, std::size_t edges_count) {
+    auto graph = make_random_graph(vertexes_count, edges_count, 42);
+    TGraph trees[3];
+    double kruskal_time = measure_seconds([&] { trees[0] = kruskal(graph); });
+    double prim_time = measure_seconds([&] { trees[1] = prim(graph); });
+    double boruvka_time = measure_seconds([&] { trees[2] = boruvka(graph); });
+    std::cout << "mst vertexes=" << vertexes_count << " edges=" << graph.Edges.size() << std::endl;
+    std::cout << "    kruskal:" << kruskal_time << "s weight:" << total_weight(trees[0]) << std::endl;
+    std::cout << "    prim:" << prim_time << "s weight:" << total_weight(trees[1]) << std::endl;
+    std::cout << "    boruvka:" << boruvka_time << "s weight:" << total_weight(trees[2])
+        << " threads:" << std::thread::hardware_concurrency() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        benchmark_mst(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
+    TGraph graph;    
+    auto a = graph.AddVertex("a");
+    auto b = graph.AddVertex("b");
+    auto c = graph.AddVertex("c");
+    auto d = graph.AddVertex("d");
+    auto e = graph.AddVertex("e");
+    auto f = graph.AddVertex("f");
+    auto g = graph.AddVertex("g");
+    auto h = graph.AddVertex("h");
+    auto i = graph.AddVertex("i");
+    graph.AddEdge(a, b, 4);
+    graph.AddEdge(b, c, 8);
+    graph.AddEdge(c, d, 7);
+    graph.AddEdge(d, e, 9);
+    graph.AddEdge(e, f, 10);
+    graph.AddEdge(g, f, 2);
+    graph.AddEdge(h, g, 1);
+    graph.AddEdge(a, h, 8);
+    graph.AddEdge(h, i, 7);
+    graph.AddEdge(i, c, 2);
+    graph.AddEdge(c, f, 4);
+    graph.AddEdge(i, g, 6);
+    graph.AddEdge(d, f, 14);
+    graph.AddEdge(b, h, 11);
+    
+    auto minimum_spanning_tree = boruvka(graph);
+    for (auto& e : minimum_spanning_tree.Edges) {
+        std::cout << "Edge v1:" << e.v1 << " v2:" << e.v2 << " weight:" << e.weight << std::endl;
+    }
+    return 0;
+}
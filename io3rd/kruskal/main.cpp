@@ -5,103 +5,75 @@
 #include <unordered_map>
 #include <deque>
 #include <algorithm>
+#include <cstdint>
 
-template<typename T>
-struct TDSPrototype {
-    T* Parent = nullptr;
-    int Rank = 0;
+enum class ECompression {
+    Full,       // second pass points every node on the path to the root
+    Halving,    // every other node on the path points to its grandparent
+    Splitting,  // every node on the path points to its grandparent
 };
 
-
-template<typename TNode>
-struct TDisjointSet { 
-    
-    void MakeSet(TNode* node) {
-        node->ds.Parent = node;
-        node->ds.Rank = 0;
-    }
-    
-    void MakeSet(TNode& node) {
-        MakeSet(&node);
-    }
-
-    TNode* FindSet(TNode* node) {
-        TNode* theParent = node;
-        // Find representative of the set (father of fathers)
-        while (theParent->ds.Parent != theParent) {
-            theParent = theParent->ds.Parent;
-        }
-        // Path compression for nodes
-        while (node != theParent) {
-            auto* tmp = node;
-            node = node->ds.Parent;
-            tmp->ds.Parent = theParent;
+// Index based union-find, 4 bytes per element: Parent[v] >= 0 is the parent of v,
+// negative value marks a root and holds minus size of its set (union by size).
+template<ECompression Compression = ECompression::Halving>
+struct TFlatDisjointSet {
+    using TId = std::uint32_t;
+
+    explicit TFlatDisjointSet(std::size_t size)
+        : Parent(size, -1)
+    {
+    }
+
+    TId FindSet(TId node) {
+        if constexpr (Compression == ECompression::Full) {
+            TId root = node;
+            while (Parent[root] >= 0) {
+                root = Parent[root];
+            }
+            while (node != root) {
+                TId next = Parent[node];
+                Parent[node] = root;
+                node = next;
+            }
+            return root;
+        } else {
+            while (Parent[node] >= 0) {
+                TId parent = Parent[node];
+                if (Parent[parent] < 0) {
+                    return parent;
+                }
+                Parent[node] = Parent[parent];
+                node = Compression == ECompression::Halving ? Parent[parent] : parent;
+            }
+            return node;
         }
-        return theParent;
     }
 
-    bool IsSameSet(TNode* node1, TNode* node2) {
-        return FindSet(node1) == FindSet(node2); 
+    bool IsSameSet(TId x, TId y) {
+        return FindSet(x) == FindSet(y);
     }
 
-    bool IsSameSet(TNode& node1, TNode& node2) {
-        return IsSameSet(&node1, &node2);
-    }
-
-    bool Union(TNode* x,  TNode* y) {
-        return Link(FindSet(x), FindSet(y));
-    }
-    
-    bool Union(TNode& x,  TNode& y) {
-        return Union(&x, &y);
-    }
-
-private:
-    bool Link(TNode* x,  TNode* y) {
+    bool Union(TId x, TId y) {
+        x = FindSet(x);
+        y = FindSet(y);
         if (x == y) {
             return false;
-        } 
-        if (x->ds.Rank > y->ds.Rank) {
-            y->ds.Parent = x;
-        } else {
-            x->ds.Parent = y;
         }
-        if (x->ds.Rank == y->ds.Rank) {
-            y->ds.Rank += 1; 
+        // Attach smaller set to the bigger one, sizes are negative
+        if (Parent[x] > Parent[y]) {
+            std::swap(x, y);
         }
+        Parent[x] += Parent[y];
+        Parent[y] = x;
         return true;
     }
-};
-
-template<typename TNode>
-struct TDisjointSetBuff : public TDisjointSet<TNode> {
-    using TParent = TDisjointSet<TNode>;
-    
-    explicit TDisjointSetBuff(std::size_t size) {
-        Buffer.resize(size);
-        for (auto& b : Buffer) {
-            TParent::MakeSet(b);
-        }
-    }
-
-    TNode& Get(std::size_t v) {
-        return Buffer[v];
-    }
-
-    bool Union(std::size_t v1, std::size_t v2) {
-        return TParent::Union(Get(v1), Get(v2));
-    }
 
-    bool IsSameSet(std::size_t v1, std::size_t v2) {
-        return TParent::IsSameSet(Get(v1), Get(v2));
-    }
-
-    TNode* FindSet(std::size_t v) {
-        return TParent::FindSet(&Get(v));
+    std::size_t SetSize(TId node) {
+        return -Parent[FindSet(node)];
     }
 
 private:
-    std::vector<TNode> Buffer;
+    std::vector<std::int32_t> Parent;
 };
 
 template<bool Directed>
@@ -153,12 +125,8 @@ struct TGraphGeneric {
 using TGraph = TGraphGeneric<false>;
 
 TGraph kruskal(const TGraph& graph) {
-    struct TAttr {
-        TDSPrototype<TAttr> ds;
-    };
-
     // Init disjoint set data structure
-    TDisjointSetBuff<TAttr> disjointSet{ graph.Vertices.size() };
+    TFlatDisjointSet<> disjointSet{ graph.Vertices.size() };
 
     // Prepare resulting graph (tree)
     TGraph result;
@@ -175,10 +143,10 @@ TGraph kruskal(const TGraph& graph) {
 
     // body of the algo
     for (const auto& e : edges) {
-        if (disjointSet.IsSameSet(e.v1, e.v2)) {
+        if (!disjointSet.Union(e.v1, e.v2)) {
+            // already in the same tree
             continue;
         }
-        disjointSet.Union(e.v1, e.v2);
         result.AddEdge(e);
     }
 
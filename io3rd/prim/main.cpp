@@ -6,6 +6,16 @@
 #include <deque>
 #include <algorithm>
 #include <queue>
+#include <numeric>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 template<bool Directed>
 struct TGraphGeneric {
@@ -22,7 +32,7 @@ struct TGraphGeneric {
     };
     using TAdjacencyList = std::vector<TVertextPath>;
     struct TVertex {
-        TVertexValue Value = 0;
+        TVertexValue Value;
         TAdjacencyList Adj;
     };
 
@@ -106,7 +116,466 @@ TGraph prim(const TGraph& graph) {
     return result;
 }
 
-int main() {
+using TMstKey = std::uint64_t;
+
+// (weight, edge id) packed so that unsigned order is weight order with ties broken by id.
+// Keys are unique, so is the MST they define, and every variant below picks the same edges.
+TMstKey mst_key(const TGraph& graph, TGraph::TEdgeId id) {
+    // flip sign bit so unsigned order of weights matches signed one
+    auto weight = static_cast<std::uint32_t>(graph.Edges[id].weight) ^ 0x8000'0000u;
+    return (TMstKey(weight) << 32) | TMstKey(id);
+}
+
+TGraph::TEdgeId mst_edge(TMstKey key) {
+    return key & 0xFFFF'FFFFu;
+}
+
+void check_32bit_ids(const TGraph& graph) {
+    if (graph.Vertices.size() >= std::numeric_limits<std::uint32_t>::max() - 1 || graph.Edges.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Graph is too big for 32 bit ids");
+    }
+}
+
+// Prim with an indexed 4-ary heap of vertices: one key per vertex (its lightest known edge to
+// the tree) and decrease-key instead of pushing every crossing edge, so the heap never holds
+// more than n entries and nothing is allocated per edge. Suits dense graphs, where the lazy
+// version above keeps O(m) stale edges. Returns MST (spanning forest) edge ids.
+std::vector<TGraph::TEdgeId> prim_indexed_mst(const TGraph& graph) {
+    constexpr std::uint32_t UNSEEN = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::uint32_t IN_TREE = UNSEEN - 1;
+    constexpr std::size_t ARITY = 4;
+    check_32bit_ids(graph);
+    const std::size_t n = graph.Vertices.size();
+
+    std::vector<TMstKey> key(n);
+    std::vector<std::uint32_t> position(n, UNSEEN);
+    std::vector<std::uint32_t> heap;
+    heap.reserve(n);
+
+    auto place = [&](std::size_t i, std::uint32_t v) {
+        heap[i] = v;
+        position[v] = i;
+    };
+    auto sift_up = [&](std::size_t i) {
+        auto v = heap[i];
+        while (i > 0) {
+            auto parent = (i - 1) / ARITY;
+            if (key[heap[parent]] <= key[v]) {
+                break;
+            }
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, v);
+    };
+    auto sift_down = [&](std::size_t i) {
+        auto v = heap[i];
+        for (;;) {
+            auto first = ARITY * i + 1;
+            if (first >= heap.size()) {
+                break;
+            }
+            auto best = first;
+            for (auto c = first + 1; c < std::min(first + ARITY, heap.size()); ++c) {
+                if (key[heap[c]] < key[heap[best]]) {
+                    best = c;
+                }
+            }
+            if (key[heap[best]] >= key[v]) {
+                break;
+            }
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, v);
+    };
+    auto scan = [&](TGraph::TVertextId u) {
+        for (const auto& path : graph.Vertices[u].Adj) {
+            auto v = path.vertex;
+            if (position[v] == IN_TREE) {
+                continue;
+            }
+            TMstKey k = mst_key(graph, path.edge);
+            if (position[v] == UNSEEN) {
+                key[v] = k;
+                heap.push_back(v);
+                sift_up(heap.size() - 1);
+            } else if (k < key[v]) {
+                key[v] = k;
+                sift_up(position[v]);
+            }
+        }
+    };
+
+    std::vector<TGraph::TEdgeId> result;
+    result.reserve(n > 0 ? n - 1 : 0);
+    for (TGraph::TVertextId root = 0; root < n; ++root) {
+        // Heap is empty here, so unseen vertices belong to another component
+        if (position[root] != UNSEEN) {
+            continue;
+        }
+        position[root] = IN_TREE;
+        scan(root);
+        while (!heap.empty()) {
+            auto v = heap.front();
+            auto last = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                place(0, last);
+                sift_down(0);
+            }
+            position[v] = IN_TREE;
+            result.push_back(mst_edge(key[v]));
+            scan(v);
+        }
+    }
+    return result;
+}
+
+// Relaxed concurrent priority queue (MultiQueue): a few sequential heaps per thread, each
+// behind its own lock. Push goes to a random heap, pop compares the cached tops of two random
+// heaps and takes from the smaller one. It returns one of the smallest elements with high
+// probability, not the smallest, and threads rarely meet on the same lock.
+class TMultiQueue {
+public:
+    struct TEntry {
+        TMstKey key;
+        std::uint32_t value;
+
+        bool operator>(const TEntry& other) const {
+            return key > other.key;
+        }
+    };
+
+    explicit TMultiQueue(std::size_t threads_count, std::size_t queues_per_thread = 2)
+        : Queues(std::max<std::size_t>(2, threads_count * queues_per_thread))
+    {
+    }
+
+    void Push(const TEntry& entry, std::mt19937& rng) {
+        for (;;) {
+            auto& queue = Queues[rng() % Queues.size()];
+            if (!queue.Lock.try_lock()) {
+                continue;
+            }
+            queue.Heap.push_back(entry);
+            std::push_heap(queue.Heap.begin(), queue.Heap.end(), std::greater<>());
+            queue.Top.store(queue.Heap.front().key, std::memory_order_relaxed);
+            queue.Lock.unlock();
+            return;
+        }
+    }
+
+    bool TryPop(TEntry& entry, std::mt19937& rng) {
+        constexpr int ATTEMPTS = 4;
+        for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+            auto& a = Queues[rng() % Queues.size()];
+            auto& b = Queues[rng() % Queues.size()];
+            auto& queue = a.Top.load(std::memory_order_relaxed) <= b.Top.load(std::memory_order_relaxed) ? a : b;
+            if (queue.Top.load(std::memory_order_relaxed) == EMPTY || !queue.Lock.try_lock()) {
+                continue;
+            }
+            bool popped = Pop(queue, entry);
+            queue.Lock.unlock();
+            if (popped) {
+                return true;
+            }
+        }
+        // Random picks keep missing: sweep all heaps before calling the queue empty
+        for (auto& queue : Queues) {
+            if (queue.Top.load(std::memory_order_relaxed) == EMPTY) {
+                continue;
+            }
+            std::lock_guard guard(queue.Lock);
+            if (Pop(queue, entry)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr TMstKey EMPTY = std::numeric_limits<TMstKey>::max();
+
+    struct alignas(64) TQueue {
+        std::mutex Lock;
+        std::vector<TEntry> Heap;
+        std::atomic<TMstKey> Top = EMPTY;
+    };
+
+    static bool Pop(TQueue& queue, TEntry& entry) {
+        if (queue.Heap.empty()) {
+            return false;
+        }
+        std::pop_heap(queue.Heap.begin(), queue.Heap.end(), std::greater<>());
+        entry = queue.Heap.back();
+        queue.Heap.pop_back();
+        queue.Top.store(queue.Heap.empty() ? EMPTY : queue.Heap.front().key, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::vector<TQueue> Queues;
+};
+
+// Runs func(begin, end, thread) over count items split into equal contiguous chunks, one per thread
+template<typename TFunc>
+void parallel_chunks(std::size_t count, std::size_t threads_count, TFunc&& func) {
+    threads_count = std::max<std::size_t>(1, std::min(threads_count, count));
+    if (threads_count == 1) {
+        func(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threads_count; ++t) {
+        std::size_t begin = count * t / threads_count;
+        std::size_t end = count * (t + 1) / threads_count;
+        threads.emplace_back([&func, begin, end, t] { func(begin, end, t); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// Parallel Prim. Every vertex starts as a fragment with a heap of its edges. Threads take
+// fragments from a MultiQueue keyed by their lightest edge and grow them Prim style: the
+// lightest edge leaving a fragment is in the MST by the cut property, whichever fragment it
+// is, so the relaxed order of the queue costs nothing in correctness. When that edge leads
+// into another fragment (a tree grown by another thread, or a single vertex) the two are
+// merged: union-find link plus small into large heap meld, and growth goes on from the union.
+//
+// A fragment is touched only under its spin lock, and a thread holding one never waits for
+// another: if the fragment across the edge is busy, its own goes back to the queue. Edges
+// which became internal are dropped when heaps are melded or when they surface.
+std::vector<TGraph::TEdgeId> parallel_prim_mst(const TGraph& graph, std::size_t threads_count = std::thread::hardware_concurrency()) {
+    using TFragmentId = std::uint32_t;
+    check_32bit_ids(graph);
+    const std::size_t n = graph.Vertices.size();
+    threads_count = std::max<std::size_t>(1, threads_count);
+
+    // parent[v] == v for fragment roots, links are made only between two locked roots
+    std::vector<std::atomic<TFragmentId>> parent(n);
+    std::vector<std::atomic<std::uint8_t>> locked(n);
+    // Crossing edge candidates of every root, min-heaps by key
+    std::vector<std::vector<TMstKey>> heaps(n);
+    TMultiQueue queue(threads_count);
+    // Roots which can still grow
+    std::atomic_size_t pending = 0;
+
+    parallel_chunks(n, threads_count, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        std::mt19937 rng(t);
+        std::size_t local = 0;
+        for (std::size_t v = begin; v < end; ++v) {
+            parent[v].store(v, std::memory_order_relaxed);
+            auto& heap = heaps[v];
+            heap.reserve(graph.Vertices[v].Adj.size());
+            for (const auto& path : graph.Vertices[v].Adj) {
+                if (path.vertex != v) {
+                    heap.push_back(mst_key(graph, path.edge));
+                }
+            }
+            std::make_heap(heap.begin(), heap.end(), std::greater<>());
+            local += !heap.empty();
+        }
+        pending += local;
+        for (std::size_t v = begin; v < end; ++v) {
+            if (!heaps[v].empty()) {
+                queue.Push({heaps[v].front(), static_cast<TFragmentId>(v)}, rng);
+            }
+        }
+    });
+
+    auto find = [&](TFragmentId v) {
+        for (;;) {
+            auto p = parent[v].load(std::memory_order_acquire);
+            if (p == v) {
+                return v;
+            }
+            // Path halving: any ancestor is a valid parent, so racing stores are harmless
+            auto grand = parent[p].load(std::memory_order_acquire);
+            if (grand != p) {
+                parent[v].store(grand, std::memory_order_relaxed);
+            }
+            v = grand;
+        }
+    };
+    auto try_lock = [&](TFragmentId f) {
+        return locked[f].load(std::memory_order_relaxed) == 0 && locked[f].exchange(1, std::memory_order_acquire) == 0;
+    };
+    auto unlock = [&](TFragmentId f) {
+        locked[f].store(0, std::memory_order_release);
+    };
+
+    std::vector<std::vector<TGraph::TEdgeId>> picked(threads_count);
+    auto worker = [&](std::size_t t) {
+        std::mt19937 rng(t + threads_count);
+        auto& result = picked[t];
+        while (pending.load(std::memory_order_acquire) > 0) {
+            TMultiQueue::TEntry entry;
+            if (!queue.TryPop(entry, rng)) {
+                // Every live fragment is held by some thread
+                std::this_thread::yield();
+                continue;
+            }
+            TFragmentId current = entry.value;
+            // A busy fragment is dropped: whoever holds it requeues or grows it
+            if (parent[current].load(std::memory_order_acquire) != current || !try_lock(current)) {
+                continue;
+            }
+            if (parent[current].load(std::memory_order_relaxed) != current || heaps[current].empty()) {
+                // Merged away or finished since the entry was pushed
+                unlock(current);
+                continue;
+            }
+            for (;;) {
+                auto& heap = heaps[current];
+                TFragmentId other = current;
+                while (!heap.empty()) {
+                    const auto& edge = graph.Edges[mst_edge(heap.front())];
+                    auto r1 = find(edge.v1);
+                    auto r2 = find(edge.v2);
+                    other = r1 == current ? r2 : r1;
+                    if (other != current) {
+                        break;
+                    }
+                    std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                    heap.pop_back();
+                }
+                if (heap.empty()) {
+                    // Spans its whole connected component
+                    std::vector<TMstKey>().swap(heap);
+                    pending.fetch_sub(1, std::memory_order_release);
+                    unlock(current);
+                    break;
+                }
+                if (!try_lock(other)) {
+                    // Unlock first: a popper that finds the fragment still locked drops the entry
+                    auto key = heap.front();
+                    unlock(current);
+                    queue.Push({key, current}, rng);
+                    break;
+                }
+                if (parent[other].load(std::memory_order_relaxed) != other) {
+                    // Was merged after find, look again
+                    unlock(other);
+                    continue;
+                }
+                result.push_back(mst_edge(heap.front()));
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                heap.pop_back();
+
+                auto survivor = heaps[current].size() >= heaps[other].size() ? current : other;
+                auto absorbed = survivor == current ? other : current;
+                auto& into = heaps[survivor];
+                auto& from = heaps[absorbed];
+                // Edges between the two would only surface as stale later
+                auto crossing = [&](TMstKey key) {
+                    const auto& edge = graph.Edges[mst_edge(key)];
+                    auto r1 = find(edge.v1);
+                    auto r2 = find(edge.v2);
+                    return !((r1 == survivor || r1 == absorbed) && (r2 == survivor || r2 == absorbed));
+                };
+                if (from.size() * 4 > into.size()) {
+                    std::copy_if(from.begin(), from.end(), std::back_inserter(into), crossing);
+                    std::make_heap(into.begin(), into.end(), std::greater<>());
+                } else {
+                    for (auto key : from) {
+                        if (crossing(key)) {
+                            into.push_back(key);
+                            std::push_heap(into.begin(), into.end(), std::greater<>());
+                        }
+                    }
+                }
+                std::vector<TMstKey>().swap(from);
+                parent[absorbed].store(survivor, std::memory_order_release);
+                // Two growing fragments became one
+                pending.fetch_sub(1, std::memory_order_release);
+                unlock(absorbed);
+                current = survivor;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads_count; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    std::vector<TGraph::TEdgeId> result;
+    for (auto& p : picked) {
+        result.insert(result.end(), p.begin(), p.end());
+    }
+    return result;
+}
+
+// Connected random graph: a random spanning tree plus uniformly random edges
+TGraph make_random_graph(std::size_t vertexes_count, std::size_t edges_count, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 1'000'000);
+    TGraph graph;
+    graph.Vertices.reserve(vertexes_count);
+    graph.Edges.reserve(edges_count);
+    for (std::size_t v = 0; v < vertexes_count; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t v = 1; v < vertexes_count; ++v) {
+        graph.AddEdge(v, rng() % v, weight(rng));
+    }
+    while (graph.Edges.size() < edges_count) {
+        graph.AddEdge(rng() % vertexes_count, rng() % vertexes_count, weight(rng));
+    }
+    return graph;
+}
+
+long long total_weight(const TGraph& tree) {
+    long long result = 0;
+    for (const auto& e : tree.Edges) {
+        result += e.weight;
+    }
+    return result;
+}
+
+long long total_weight(const TGraph& graph, const std::vector<TGraph::TEdgeId>& tree) {
+    long long result = 0;
+    for (auto id : tree) {
+        result += graph.Edges[id].weight;
+    }
+    return result;
+}
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <vertexes> <edges> [threads], dense graphs: ./a.out 5000 10000000
+void benchmark_prim(std::size_t vertexes_count, std::size_t edges_count, std::size_t threads_count) {
+    auto graph = make_random_graph(vertexes_count, edges_count, 42);
+    TGraph lazy;
+    std::vector<TGraph::TEdgeId> indexed;
+    std::vector<TGraph::TEdgeId> parallel;
+    double lazy_time = measure_seconds([&] { lazy = prim(graph); });
+    double indexed_time = measure_seconds([&] { indexed = prim_indexed_mst(graph); });
+    double parallel_time = measure_seconds([&] { parallel = parallel_prim_mst(graph, threads_count); });
+    std::cout << "prim vertexes=" << vertexes_count << " edges=" << graph.Edges.size() << std::endl;
+    std::cout << "    priority_queue:" << lazy_time << "s weight:" << total_weight(lazy) << std::endl;
+    std::cout << "    indexed heap:" << indexed_time << "s weight:" << total_weight(graph, indexed)
+        << " speedup:" << lazy_time / indexed_time << std::endl;
+    std::cout << "    parallel:" << parallel_time << "s weight:" << total_weight(graph, parallel)
+        << " speedup:" << lazy_time / parallel_time << " threads:" << threads_count << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        benchmark_prim(std::stoul(argv[1]), std::stoul(argv[2]), argc > 3 ? std::stoul(argv[3]) : std::thread::hardware_concurrency());
+        return 0;
+    }
+
     TGraph graph;    
     auto a = graph.AddVertex("a");
     auto b = graph.AddVertex("b");
@@ -136,5 +605,7 @@ int main() {
     for (auto& e : minimum_spanning_tree.Edges) {
         std::cout << "Edge v1:" << e.v1 << " v2:" << e.v2 << " weight:" << e.weight << std::endl;
     }
+    std::cout << "indexed heap weight:" << total_weight(graph, prim_indexed_mst(graph))
+        << " parallel weight:" << total_weight(graph, parallel_prim_mst(graph, 4)) << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -6,6 +6,13 @@
 #include <deque>
 #include <set>
 #include <algorithm>
+#include <numeric>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <chrono>
+#include <random>
 
 
 template<bool Directed>
@@ -159,10 +166,111 @@ TConnectedComponents ConnectedComponents(const TGraph& input) {
     }
     return connectedComponents;
 }
+
+struct TComponentIds {
+    // Component of every vertex. Components are numbered in reverse topological order:
+    // an edge between two components always goes from a larger id to a smaller one.
+    std::vector<std::uint32_t> Component;
+    std::uint32_t Count = 0;
+};
+
+// One pass, non recursive SCC (Pearce's variant of Tarjan). No transposed copy:
+// besides the answer it keeps one 32-bit rindex per vertex, one root bit per vertex,
+// the explicit call stack and the Tarjan stack.
+//
+// rindex[v] is the DFS index of v while v is open and is lowered to the smallest index
+// reachable from its subtree. Once v's component is complete, all of its vertices get
+// rindex = component id counted down from n-1, which is larger than any open index,
+// so finished vertices never lower an open one.
+TComponentIds TarjanComponentIds(const TGraph& input) {
+    const std::size_t n = input.Vertices.size();
+    std::vector<std::uint32_t> rindex(n, 0);
+    std::vector<bool> root(n, false);
+    struct TFrame {
+        TGraph::TVertextId vertex;
+        std::size_t edge;
+    };
+    std::vector<TFrame> callStack;
+    std::vector<TGraph::TVertextId> tarjanStack;
+    std::uint32_t index = 1;
+    std::size_t count = 0;
+
+    auto open = [&](TGraph::TVertextId v) {
+        rindex[v] = index++;
+        root[v] = true;
+        callStack.push_back(TFrame{.vertex = v, .edge = 0});
+    };
+
+    for (TGraph::TVertextId start = 0; start < n; ++start) {
+        if (rindex[start] != 0) {
+            continue;
+        }
+        open(start);
+        while (!callStack.empty()) {
+            auto& frame = callStack.back();
+            auto v = frame.vertex;
+            const auto& adj = input.Vertices[v].Adj;
+            if (frame.edge < adj.size()) {
+                auto w = adj[frame.edge++];
+                if (rindex[w] == 0) {
+                    open(w);
+                } else if (rindex[w] < rindex[v]) {
+                    rindex[v] = rindex[w];
+                    root[v] = false;
+                }
+                continue;
+            }
+            // All edges of v are explored
+            callStack.pop_back();
+            if (root[v]) {
+                --index;
+                while (!tarjanStack.empty() && rindex[v] <= rindex[tarjanStack.back()]) {
+                    rindex[tarjanStack.back()] = n - 1 - count;
+                    tarjanStack.pop_back();
+                    --index;
+                }
+                rindex[v] = n - 1 - count++;
+            } else {
+                tarjanStack.push_back(v);
+            }
+            if (!callStack.empty()) {
+                auto parent = callStack.back().vertex;
+                if (rindex[v] < rindex[parent]) {
+                    rindex[parent] = rindex[v];
+                    root[parent] = false;
+                }
+            }
+        }
+    }
+
+    // Components were numbered n-1, n-2, ... in reverse topological order
+    for (auto& r : rindex) {
+        r = n - 1 - r;
+    }
+    return TComponentIds{.Component = std::move(rindex), .Count = static_cast<std::uint32_t>(count)};
+}
+
+TConnectedComponents TarjanConnectedComponents(const TGraph& input) {
+    auto ids = TarjanComponentIds(input);
+    // Bucket vertices by component keeping the reverse topological order
+    std::vector<std::uint32_t> sizes(ids.Count, 0);
+    for (auto c : ids.Component) {
+        ++sizes[c];
+    }
+    TConnectedComponents connectedComponents(ids.Count);
+    for (std::size_t c = 0; c < ids.Count; ++c) {
+        connectedComponents[c].reserve(sizes[c]);
+    }
+    for (TGraph::TVertextId v = 0; v < input.Vertices.size(); ++v) {
+        connectedComponents[ids.Component[v]].push_back(v);
+    }
+    return connectedComponents;
+}
+
 // Make simplified graph where each strongly connected component represened by single representative 
 TGraph StronglyConnectedGraph(const TGraph& input) {
     // Calculate strongly connected components
-    TConnectedComponents components = ConnectedComponents(input);
+    TConnectedComponents components = TarjanConnectedComponents(input);
 
     // Calculate vertex 2 componnet mapping (disjoint set alternative)
     std::vector<int> invertedIndex(input.Vertices.size(), 0);
@@ -192,7 +300,172 @@ TGraph StronglyConnectedGraph(const TGraph& input) {
     return simplified;
 }
 
-int main() {
+// Longest path (in vertices) starting at every vertex of the acyclic simplified graph.
+// The graph is semiconnected iff all of them are distinct.
+std::vector<int> PathDegrees(const TGraph& simplified, const std::vector<TGraph::TVertextId>& toposorted) {
+    std::vector<int> degrees(toposorted.size(), 0);
+    for (auto it = toposorted.rbegin(); it != toposorted.rend(); ++it) {
+        auto v = *it;
+        int max_parent = 0;
+        for (auto a : simplified.Vertices[v].Adj) {
+            max_parent = std::max(max_parent, degrees[a]);
+        }
+        degrees[v] = max_parent + 1;
+    }
+    return degrees;
+}
+
+bool IsSemiconnected(const TGraph& graph) {
+    auto simplified = StronglyConnectedGraph(graph);
+    auto degrees = PathDegrees(simplified, TopologicalSort(simplified));
+    std::sort(degrees.begin(), degrees.end());
+    return std::unique(degrees.begin(), degrees.end()) == degrees.end();
+}
+
+// Condensation DAG in CSR form without parallel edges. Vertices are component ids of
+// TComponentIds, targets of every row are sorted ascending.
+struct TCondensation {
+    std::uint32_t Count = 0;
+    std::vector<std::uint32_t> Offsets;
+    std::vector<std::uint32_t> Targets;
+};
+
+// LSD radix sort of keys below 2^bits, 11 bit digits
+void RadixSort(std::vector<std::uint64_t>& keys, unsigned bits) {
+    constexpr unsigned DIGIT_BITS = 11;
+    constexpr std::size_t BUCKETS = std::size_t(1) << DIGIT_BITS;
+    std::vector<std::uint64_t> buffer(keys.size());
+    for (unsigned shift = 0; shift < bits; shift += DIGIT_BITS) {
+        std::array<std::size_t, BUCKETS> start{};
+        for (auto key : keys) {
+            ++start[(key >> shift) & (BUCKETS - 1)];
+        }
+        std::exclusive_scan(start.begin(), start.end(), start.begin(), std::size_t(0));
+        for (auto key : keys) {
+            buffer[start[(key >> shift) & (BUCKETS - 1)]++] = key;
+        }
+        keys.swap(buffer);
+    }
+}
+
+// Edges between components are packed into (from, to) keys, radix sorted and deduplicated,
+// the sorted keys are the CSR rows already
+TCondensation Condense(const TGraph& input, const TComponentIds& ids) {
+    const unsigned idBits = std::max<unsigned>(1, std::bit_width(ids.Count));
+    std::vector<std::uint64_t> keys;
+    keys.reserve(input.Edges.size());
+    for (const auto& e : input.Edges) {
+        auto c1 = ids.Component[e.v1];
+        auto c2 = ids.Component[e.v2];
+        if (c1 != c2) {
+            keys.push_back((std::uint64_t(c1) << idBits) | c2);
+        }
+    }
+    RadixSort(keys, 2 * idBits);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    TCondensation result;
+    result.Count = ids.Count;
+    result.Offsets.assign(ids.Count + 1, 0);
+    result.Targets.reserve(keys.size());
+    const std::uint64_t mask = (std::uint64_t(1) << idBits) - 1;
+    for (auto key : keys) {
+        ++result.Offsets[(key >> idBits) + 1];
+        result.Targets.push_back(key & mask);
+    }
+    std::partial_sum(result.Offsets.begin(), result.Offsets.end(), result.Offsets.begin());
+    return result;
+}
+
+// A DAG has a Hamiltonian path iff consecutive vertices of its topological order are adjacent,
+// then the order is unique and the path visits every component, so every pair of vertices is
+// connected one way. Component ids are a reverse topological order and rows are sorted, so
+// the edge c -> c - 1 can only be the last one of row c: O(components) after the condensation.
+bool IsSemiconnected(const TCondensation& dag) {
+    for (std::uint32_t c = 1; c < dag.Count; ++c) {
+        auto begin = dag.Offsets[c];
+        auto end = dag.Offsets[c + 1];
+        if (begin == end || dag.Targets[end - 1] != c - 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsSemiconnectedLinear(const TGraph& graph) {
+    return IsSemiconnected(Condense(graph, TarjanComponentIds(graph)));
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Vertices in random order on a Hamiltonian path, plus random edges: forward ones along the path
+// and a share of short backward ones, which glue stretches of the path into components. With
+// broken set one path edge in the middle is missing and no edge jumps over it.
+TGraph MakePathGraph(std::size_t vertexesCount, std::size_t edgesCount, bool broken, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<TGraph::TVertextId> order(vertexesCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    TGraph graph;
+    graph.Vertices.resize(vertexesCount);
+    std::size_t skipped = broken ? vertexesCount / 2 : vertexesCount;
+    for (std::size_t i = 0; i + 1 < vertexesCount; ++i) {
+        if (i != skipped) {
+            graph.AddEdge(order[i], order[i + 1]);
+        }
+    }
+    while (graph.Edges.size() < edgesCount) {
+        std::size_t i = rng() % vertexesCount;
+        std::size_t j = rng() % vertexesCount;
+        if (i > j) {
+            std::swap(i, j);
+        }
+        bool backward = rng() % 8 == 0;
+        if (backward) {
+            // Short ones only, long ones would merge everything into one component
+            j = std::min(i + 1 + rng() % 8, vertexesCount - 1);
+        }
+        if (i == j || (broken && i <= skipped && skipped < j)) {
+            continue;
+        }
+        graph.AddEdge(order[backward ? j : i], order[backward ? i : j]);
+    }
+    return graph;
+}
+
+// Usage: ./a.out <vertexes> <edges>
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount) {
+    for (bool broken : {false, true}) {
+        auto graph = MakePathGraph(vertexesCount, edgesCount, broken, 42);
+        TComponentIds ids;
+        double sccTime = MeasureSeconds([&] { ids = TarjanComponentIds(graph); });
+        TCondensation dag;
+        double condenseTime = MeasureSeconds([&] { dag = Condense(graph, ids); });
+        bool linear = false;
+        double checkTime = MeasureSeconds([&] { linear = IsSemiconnected(dag); });
+        bool levels = false;
+        double levelsTime = MeasureSeconds([&] { levels = IsSemiconnected(graph); });
+        double linearTime = sccTime + condenseTime + checkTime;
+        std::cout << "vertexes:" << vertexesCount << " edges:" << graph.Edges.size()
+            << " components:" << dag.Count << " condensed edges:" << dag.Targets.size()
+            << " semiconnected:" << linear << (linear == levels ? "" : " MISMATCH") << std::endl
+            << "  linear: " << linearTime << "s (scc " << sccTime << "s, condense " << condenseTime << "s, path check " << checkTime << "s)" << std::endl
+            << "  simplified TGraph + topological sort: " << levelsTime << "s"
+            << " speedup:" << levelsTime / linearTime << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
     TGraph graph;    
     auto a = graph.AddVertex("a");
     auto b = graph.AddVertex("b");
@@ -209,16 +482,7 @@ int main() {
 
     // auto components = ConnectedComponents(graph);
     auto simplified = StronglyConnectedGraph(graph);
-    auto toposorted = TopologicalSort(simplified);
-    std::vector<int> degrees(toposorted.size(), 0);
-    for (auto it = toposorted.rbegin(); it != toposorted.rend(); ++it) {
-        auto v = *it;
-        int max_parent = 0;
-        for (auto a : simplified.Vertices[v].Adj) {
-            max_parent = std::max(max_parent, degrees[a]);
-        }
-        degrees[v] = max_parent + 1;
-    }
+    auto degrees = PathDegrees(simplified, TopologicalSort(simplified));
     
     for (int i = 0; i < degrees.size(); ++i) {
         std::cout << "vertex " << simplified.Vertices[i].Value << " degree:" << degrees[i] << std::endl;
@@ -226,6 +490,7 @@ int main() {
 
     std::sort(degrees.begin(), degrees.end());
     std::cout << "Is semiconnected: " << ( std::unique(degrees.begin(), degrees.end()) == degrees.end() ) << std::endl;
+    std::cout << "Is semiconnected (linear): " << IsSemiconnectedLinear(graph) << std::endl;
 
 
     // for (const auto& comp : components) {
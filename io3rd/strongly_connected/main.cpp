@@ -4,6 +4,16 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <deque>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <sys/resource.h>
 
 
 template<bool Directed>
@@ -153,7 +163,441 @@ TConnectedComponents ConnectedComponents(const TGraph& input) {
     return connectedComponents;
 }
 
-int main() {
+// One pass, non recursive SCC (Pearce's variant of Tarjan). No transposed copy:
+// besides the answer it keeps one 32-bit rindex per vertex, one root bit per vertex,
+// the explicit call stack and the Tarjan stack.
+//
+// rindex[v] is the DFS index of v while v is open and is lowered to the smallest index
+// reachable from its subtree. Once v's component is complete, all of its vertices get
+// rindex = component id counted down from n-1, which is larger than any open index,
+// so finished vertices never lower an open one.
+TConnectedComponents TarjanConnectedComponents(const TGraph& input) {
+    const std::size_t n = input.Vertices.size();
+    std::vector<std::uint32_t> rindex(n, 0);
+    std::vector<bool> root(n, false);
+    struct TFrame {
+        TGraph::TVertextId vertex;
+        std::size_t edge;
+    };
+    std::vector<TFrame> callStack;
+    std::vector<TGraph::TVertextId> tarjanStack;
+    std::uint32_t index = 1;
+    std::size_t count = 0;
+
+    auto open = [&](TGraph::TVertextId v) {
+        rindex[v] = index++;
+        root[v] = true;
+        callStack.push_back(TFrame{.vertex = v, .edge = 0});
+    };
+
+    for (TGraph::TVertextId start = 0; start < n; ++start) {
+        if (rindex[start] != 0) {
+            continue;
+        }
+        open(start);
+        while (!callStack.empty()) {
+            auto& frame = callStack.back();
+            auto v = frame.vertex;
+            const auto& adj = input.Vertices[v].Adj;
+            if (frame.edge < adj.size()) {
+                auto w = adj[frame.edge++];
+                if (rindex[w] == 0) {
+                    open(w);
+                } else if (rindex[w] < rindex[v]) {
+                    rindex[v] = rindex[w];
+                    root[v] = false;
+                }
+                continue;
+            }
+            // All edges of v are explored
+            callStack.pop_back();
+            if (root[v]) {
+                --index;
+                while (!tarjanStack.empty() && rindex[v] <= rindex[tarjanStack.back()]) {
+                    rindex[tarjanStack.back()] = n - 1 - count;
+                    tarjanStack.pop_back();
+                    --index;
+                }
+                rindex[v] = n - 1 - count++;
+            } else {
+                tarjanStack.push_back(v);
+            }
+            if (!callStack.empty()) {
+                auto parent = callStack.back().vertex;
+                if (rindex[v] < rindex[parent]) {
+                    rindex[parent] = rindex[v];
+                    root[parent] = false;
+                }
+            }
+        }
+    }
+
+    // Components were numbered n-1, n-2, ... in reverse topological order,
+    // bucket vertices by component keeping that order.
+    std::vector<std::uint32_t> sizes(count, 0);
+    for (TGraph::TVertextId v = 0; v < n; ++v) {
+        ++sizes[n - 1 - rindex[v]];
+    }
+    TConnectedComponents connectedComponents(count);
+    for (std::size_t c = 0; c < count; ++c) {
+        connectedComponents[c].reserve(sizes[c]);
+    }
+    for (TGraph::TVertextId v = 0; v < n; ++v) {
+        connectedComponents[n - 1 - rindex[v]].push_back(v);
+    }
+    return connectedComponents;
+}
+
+// Runs func(begin, end) over count items split into contiguous chunks, one per thread
+template<typename TFunc>
+void ParallelChunks(std::size_t count, std::size_t threadsCount, TFunc&& func) {
+    threadsCount = std::max<std::size_t>(1, std::min(threadsCount, count));
+    if (threadsCount == 1) {
+        func(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&func, t, count, threadsCount] {
+            func(count * t / threadsCount, count * (t + 1) / threadsCount, t);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// Parallel SCC decomposition: forward-backward reachability with trimming (Multistep style).
+//   1. Trim: vertices without live in- or out- neighbours are singleton SCCs.
+//   2. FW-BW: pick a pivot of a partition, everything reachable both forward and backward
+//      is its SCC; forward only, backward only and the rest are three independent partitions.
+// Big partitions (the giant SCC of web graphs) run level synchronous BFS on all threads,
+// small ones are handed out to a pool of workers, one partition per worker.
+//
+// Every partition has its own color, vertices are recolored with compare-and-swap,
+// so a BFS never leaves its partition and never claims a vertex twice.
+struct TParallelSccContext {
+    using TId = std::uint32_t;
+    static constexpr TId DONE = std::numeric_limits<TId>::max();
+    // Partitions smaller than that are solved by a single worker
+    static constexpr std::size_t PARALLEL_THRESHOLD = 1 << 16;
+
+    struct TTask {
+        TId Color = 0;
+        std::vector<TId> Vertices;
+    };
+
+    TParallelSccContext(const TGraph& graph, std::size_t threadsCount)
+        : Graph(graph)
+        , ThreadsCount(std::max<std::size_t>(1, threadsCount))
+        , Color(graph.Vertices.size(), 0)
+        , Scc(graph.Vertices.size(), DONE)
+    {
+        // Transposed graph as CSR, two flat arrays instead of a TGraph copy
+        const std::size_t n = graph.Vertices.size();
+        InOffsets.assign(n + 1, 0);
+        for (const auto& e : graph.Edges) {
+            ++InOffsets[e.v2 + 1];
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            InOffsets[v + 1] += InOffsets[v];
+        }
+        InEdges.resize(graph.Edges.size());
+        std::vector<std::size_t> fill(InOffsets.begin(), InOffsets.end() - 1);
+        for (const auto& e : graph.Edges) {
+            InEdges[fill[e.v2]++] = e.v1;
+        }
+    }
+
+    TConnectedComponents Run() {
+        Trim();
+        TTask root;
+        for (TId v = 0; v < Graph.Vertices.size(); ++v) {
+            if (Load(v) != DONE) {
+                root.Vertices.push_back(v);
+            }
+        }
+        if (!root.Vertices.empty()) {
+            std::vector<TTask> big{std::move(root)};
+            std::vector<TTask> small;
+            while (!big.empty()) {
+                TTask task = std::move(big.back());
+                big.pop_back();
+                for (auto& sub : Split(task, ThreadsCount)) {
+                    (sub.Vertices.size() >= PARALLEL_THRESHOLD ? big : small).push_back(std::move(sub));
+                }
+            }
+            RunPool(std::move(small));
+        }
+
+        const std::size_t count = NextScc;
+        std::vector<std::uint32_t> sizes(count, 0);
+        for (auto id : Scc) {
+            ++sizes[id];
+        }
+        TConnectedComponents components(count);
+        for (std::size_t c = 0; c < count; ++c) {
+            components[c].reserve(sizes[c]);
+        }
+        for (TGraph::TVertextId v = 0; v < Scc.size(); ++v) {
+            components[Scc[v]].push_back(v);
+        }
+        return components;
+    }
+
+private:
+    TId Load(TId v) {
+        return std::atomic_ref<TId>(Color[v]).load(std::memory_order_relaxed);
+    }
+
+    bool Claim(TId v, TId from, TId to) {
+        return std::atomic_ref<TId>(Color[v]).compare_exchange_strong(from, to, std::memory_order_relaxed);
+    }
+
+    bool HasLive(TId v, TId color, bool forward) {
+        if (forward) {
+            for (auto w : Graph.Vertices[v].Adj) {
+                if (w != v && Load(w) == color) {
+                    return true;
+                }
+            }
+        } else {
+            for (auto i = InOffsets[v]; i < InOffsets[v + 1]; ++i) {
+                if (InEdges[i] != v && Load(InEdges[i]) == color) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Rounds of parallel trimming until a round removes less than 1% of live vertices,
+    // long chains are left to FW-BW.
+    void Trim() {
+        const std::size_t n = Graph.Vertices.size();
+        std::size_t live = n;
+        while (live > 0) {
+            std::atomic_size_t trimmed = 0;
+            ParallelChunks(n, ThreadsCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+                std::size_t local = 0;
+                for (TId v = begin; v < end; ++v) {
+                    TId color = Load(v);
+                    if (color == DONE || (HasLive(v, color, true) && HasLive(v, color, false))) {
+                        continue;
+                    }
+                    if (Claim(v, color, DONE)) {
+                        Scc[v] = NextScc++;
+                        ++local;
+                    }
+                }
+                trimmed += local;
+            });
+            live -= trimmed;
+            if (trimmed * 100 < live) {
+                break;
+            }
+        }
+    }
+
+    // Claims every vertex reachable from start (start included) with claim(v) and
+    // returns them. Level synchronous, a level is spread over threadsCount threads.
+    template<typename TClaim>
+    std::vector<TId> Reach(TId start, bool forward, std::size_t threadsCount, TClaim&& claim) {
+        std::vector<TId> reached;
+        if (!claim(start)) {
+            return reached;
+        }
+        std::vector<TId> frontier{start};
+        std::vector<std::vector<TId>> next(threadsCount);
+        while (!frontier.empty()) {
+            reached.insert(reached.end(), frontier.begin(), frontier.end());
+            ParallelChunks(frontier.size(), threadsCount, [&](std::size_t begin, std::size_t end, std::size_t t) {
+                auto& local = next[t];
+                for (std::size_t i = begin; i < end; ++i) {
+                    TId v = frontier[i];
+                    if (forward) {
+                        for (auto w : Graph.Vertices[v].Adj) {
+                            if (claim(w)) {
+                                local.push_back(w);
+                            }
+                        }
+                    } else {
+                        for (auto e = InOffsets[v]; e < InOffsets[v + 1]; ++e) {
+                            if (claim(InEdges[e])) {
+                                local.push_back(InEdges[e]);
+                            }
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (auto& local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+        }
+        return reached;
+    }
+
+    // One FW-BW step: assigns the pivot's SCC and returns the remaining partitions
+    std::vector<TTask> Split(TTask& task, std::size_t threadsCount) {
+        // Pivot with the biggest in*out degree is likely to sit in the biggest SCC
+        TId pivot = task.Vertices.front();
+        std::size_t best = 0;
+        for (auto v : task.Vertices) {
+            std::size_t score = (Graph.Vertices[v].Adj.size() + 1) * (InOffsets[v + 1] - InOffsets[v] + 1);
+            if (score > best) {
+                best = score;
+                pivot = v;
+            }
+        }
+
+        const TId color = task.Color;
+        const TId forwardColor = NextColor++;
+        const TId backwardColor = NextColor++;
+        Reach(pivot, true, threadsCount, [&](TId w) {
+            return Claim(w, color, forwardColor);
+        });
+        const TId sccId = NextScc++;
+        auto component = Reach(pivot, false, threadsCount, [&](TId w) {
+            return Claim(w, forwardColor, DONE) || Claim(w, color, backwardColor);
+        });
+        for (auto v : component) {
+            if (Load(v) == DONE) {
+                Scc[v] = sccId;
+            }
+        }
+
+        std::vector<TTask> result(3);
+        result[0].Color = color;
+        result[1].Color = forwardColor;
+        result[2].Color = backwardColor;
+        for (auto v : task.Vertices) {
+            TId c = Load(v);
+            if (c != DONE) {
+                result[c == color ? 0 : c == forwardColor ? 1 : 2].Vertices.push_back(v);
+            }
+        }
+        std::erase_if(result, [](const TTask& t) { return t.Vertices.empty(); });
+        return result;
+    }
+
+    void RunPool(std::vector<TTask> tasks) {
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::size_t running = 0;
+        auto worker = [&] {
+            std::unique_lock lock(mutex);
+            while (true) {
+                wakeup.wait(lock, [&] { return !tasks.empty() || running == 0; });
+                if (tasks.empty()) {
+                    return;
+                }
+                TTask task = std::move(tasks.back());
+                tasks.pop_back();
+                ++running;
+                lock.unlock();
+                auto subTasks = Split(task, 1);
+                lock.lock();
+                --running;
+                for (auto& sub : subTasks) {
+                    tasks.push_back(std::move(sub));
+                }
+                wakeup.notify_all();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (std::size_t t = 1; t < ThreadsCount; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    const TGraph& Graph;
+    const std::size_t ThreadsCount;
+    std::vector<std::size_t> InOffsets;
+    std::vector<TId> InEdges;
+    std::vector<TId> Color;
+    std::vector<TId> Scc;
+    std::atomic<TId> NextColor = 1;
+    std::atomic<TId> NextScc = 0;
+};
+
+TConnectedComponents ParallelConnectedComponents(const TGraph& input, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+    return TParallelSccContext(input, threadsCount).Run();
+}
+
+// Power law "web like" graph (R-MAT with a=0.57, b=c=0.19)
+TGraph MakeRmatGraph(std::size_t scale, std::size_t edgesCount, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dice(0, 1);
+    TGraph graph;
+    const std::size_t n = std::size_t(1) << scale;
+    graph.Vertices.reserve(n);
+    graph.Edges.reserve(edgesCount);
+    for (std::size_t v = 0; v < n; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        std::size_t v1 = 0;
+        std::size_t v2 = 0;
+        for (std::size_t bit = 0; bit < scale; ++bit) {
+            double r = dice(rng);
+            v1 = v1 * 2 + (r >= 0.76);
+            v2 = v2 * 2 + (r >= 0.57 && r < 0.76) + (r >= 0.95);
+        }
+        graph.AddEdge(v1, v2);
+    }
+    return graph;
+}
+
+TConnectedComponents Canonical(TConnectedComponents components) {
+    for (auto& c : components) {
+        std::sort(c.begin(), c.end());
+    }
+    std::sort(components.begin(), components.end());
+    return components;
+}
+
+long PeakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Usage: ./a.out <scale> <edges>, e.g. ./a.out 22 50000000
+// Tarjan runs first, so the growth of the peak RSS shows the extra memory of each algorithm.
+void Benchmark(std::size_t scale, std::size_t edgesCount) {
+    TGraph graph = MakeRmatGraph(scale, edgesCount, 42);
+    TConnectedComponents results[3];
+    const char* names[3] = {"tarjan", "kosaraju", "parallel fw-bw"};
+    for (int i = 0; i < 3; ++i) {
+        long rssBefore = PeakRssKb();
+        auto start = std::chrono::steady_clock::now();
+        switch (i) {
+            case 0: results[i] = TarjanConnectedComponents(graph); break;
+            case 1: results[i] = ConnectedComponents(graph); break;
+            default: results[i] = ParallelConnectedComponents(graph); break;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << names[i] << " vertexes:" << graph.Vertices.size() << " edges:" << graph.Edges.size()
+            << " time:" << seconds << "s"
+            << " components:" << results[i].size()
+            << " peak rss growth:" << (PeakRssKb() - rssBefore) / 1024 << "MB" << std::endl;
+    }
+    auto expected = Canonical(results[0]);
+    std::cout << "same components: " << (expected == Canonical(results[1]) && expected == Canonical(results[2])) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
     TGraph graph;    
     auto a = graph.AddVertex("a");
     auto b = graph.AddVertex("b");
@@ -188,7 +632,7 @@ int main() {
     
     graph.AddEdge(h, h);
     
-    TConnectedComponents components = ConnectedComponents(graph);
+    TConnectedComponents components = TarjanConnectedComponents(graph);
 
     for (const auto& comp : components) {
         for (auto v  : comp) {
@@ -3,6 +3,12 @@
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <memory>
 
 template<typename T>
 struct DSPrototype {
@@ -232,7 +238,196 @@ void LCA(TTreeNodePtr root, LCAContext& ctx) {
     }
 }
 
-int main() {
+// Online LCA for a static tree: Euler tour + linear range minimum, O(n) build and memory,
+// O(1) per query. Nodes get ids in preorder, then within the Euler tour between any two nodes
+// the LCA is the node with the smallest id (every node there is in the LCA subtree, and the
+// LCA comes first in preorder), so the range minimum works on plain ids, no depths needed.
+//
+// The tour is cut into blocks of 64. A sparse table over block minimums answers the whole
+// blocks of a range, it has m / 64 * log(m / 64) < m entries. Inside a block, Mask[i] is
+// the min stack of the block prefix ending at i as a bitmask, so the minimum of [l, i] is
+// at the lowest stack bit which is >= l.
+struct TLcaIndex {
+    using TId = std::uint32_t;
+
+    explicit TLcaIndex(TTreeNodePtr root) {
+        if (root == nullptr) {
+            return;
+        }
+        // Iterative DFS: node id on entry, repeat parent id after every child
+        struct TFrame {
+            TTreeNodePtr node;
+            TId id;
+            int child;
+        };
+        std::vector<TFrame> stack;
+        auto enter = [&](TTreeNodePtr node) {
+            TId id = Nodes.size();
+            Ids.emplace(node, id);
+            Nodes.push_back(node);
+            First.push_back(Euler.size());
+            Euler.push_back(id);
+            stack.push_back(TFrame{.node = node, .id = id, .child = 0});
+        };
+        enter(root);
+        while (!stack.empty()) {
+            auto& frame = stack.back();
+            if (frame.child == 2) {
+                stack.pop_back();
+                if (!stack.empty()) {
+                    Euler.push_back(stack.back().id);
+                }
+                continue;
+            }
+            TTreeNodePtr child = frame.child++ == 0 ? frame.node->left : frame.node->right;
+            if (child != nullptr) {
+                enter(child);
+            }
+        }
+
+        const std::size_t m = Euler.size();
+        Mask.resize(m);
+        BlocksCount = (m + BLOCK - 1) / BLOCK;
+        Levels = std::bit_width(BlocksCount);
+        Table.resize(Levels * BlocksCount);
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t offset = i % BLOCK;
+            std::uint64_t stack = offset == 0 ? 0 : Mask[i - 1];
+            while (stack != 0 && Euler[i - offset + std::bit_width(stack) - 1] > Euler[i]) {
+                stack ^= std::uint64_t(1) << (std::bit_width(stack) - 1);
+            }
+            Mask[i] = stack | (std::uint64_t(1) << offset);
+            if (offset == BLOCK - 1 || i + 1 == m) {
+                // Bottom of the stack is the block minimum
+                Table[i / BLOCK] = Euler[i - offset + std::countr_zero(Mask[i])];
+            }
+        }
+        // Table[k][b] = min of blocks [b .. b + 2^k), levels are stored one after another
+        for (std::size_t k = 1; k < Levels; ++k) {
+            const TId* prev = Table.data() + (k - 1) * BlocksCount;
+            TId* current = Table.data() + k * BlocksCount;
+            const std::size_t half = std::size_t(1) << (k - 1);
+            for (std::size_t b = 0; b + 2 * half <= BlocksCount; ++b) {
+                current[b] = std::min(prev[b], prev[b + half]);
+            }
+        }
+    }
+
+    TId Id(TTreeNodePtr node) const {
+        return Ids.at(node);
+    }
+
+    TTreeNodePtr Node(TId id) const {
+        return Nodes[id];
+    }
+
+    TId Lca(TId u, TId v) const {
+        std::size_t l = First[u];
+        std::size_t r = First[v];
+        if (l > r) {
+            std::swap(l, r);
+        }
+        const std::size_t lb = l / BLOCK;
+        const std::size_t rb = r / BLOCK;
+        if (lb == rb) {
+            return InBlock(l, r);
+        }
+        TId result = std::min(InBlock(l, lb * BLOCK + BLOCK - 1), InBlock(rb * BLOCK, r));
+        if (lb + 1 < rb) {
+            const std::size_t k = std::bit_width(rb - lb - 1) - 1;
+            const TId* level = Table.data() + k * BlocksCount;
+            result = std::min({result, level[lb + 1], level[rb - (std::size_t(1) << k)]});
+        }
+        return result;
+    }
+
+    TTreeNodePtr Lca(TTreeNodePtr u, TTreeNodePtr v) const {
+        return Node(Lca(Id(u), Id(v)));
+    }
+
+    // Answers queries[i] into result[i], result is resized to fit
+    void LcaBatch(const std::vector<std::pair<TId, TId>>& queries, std::vector<TId>& result) const {
+        result.resize(queries.size());
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            result[i] = Lca(queries[i].first, queries[i].second);
+        }
+    }
+
+    std::size_t Size() const {
+        return Nodes.size();
+    }
+
+private:
+    static constexpr std::size_t BLOCK = 64;
+
+    // l and r are in one block
+    TId InBlock(std::size_t l, std::size_t r) const {
+        const std::uint64_t stack = Mask[r] & (~std::uint64_t(0) << (l % BLOCK));
+        return Euler[r - r % BLOCK + std::countr_zero(stack)];
+    }
+
+    std::unordered_map<TTreeNodePtr, TId> Ids;
+    std::vector<TTreeNodePtr> Nodes;
+    std::vector<std::size_t> First;
+    std::vector<TId> Euler;
+    std::vector<std::uint64_t> Mask;
+    std::size_t BlocksCount = 0;
+    std::size_t Levels = 0;
+    // Block minimums
+    std::vector<TId> Table;
+};
+
+template<typename TFunc>
+double measure_seconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: ./a.out <tree size> <queries>
+// Offline Tarjan answers all pairs at once (quadratic), so keep the tree small for it.
+void benchmark_lca(std::size_t size, std::size_t queries_count) {
+    std::mt19937 rng(42);
+    TTreeNodePtr root = nullptr;
+    for (std::size_t i = 0; i < size; ++i) {
+        insert(root, rng());
+    }
+
+    LCAContext ctx;
+    double tarjan = measure_seconds([&] { LCA(root, ctx); });
+
+    std::unique_ptr<TLcaIndex> index;
+    double build = measure_seconds([&] { index = std::make_unique<TLcaIndex>(root); });
+
+    bool same = true;
+    for (const auto& [pair, lca] : ctx.results) {
+        same = same && index->Lca(pair.first, pair.second) == lca;
+    }
+
+    std::uniform_int_distribution<TLcaIndex::TId> node(0, index->Size() - 1);
+    std::vector<std::pair<TLcaIndex::TId, TLcaIndex::TId>> queries(queries_count);
+    for (auto& q : queries) {
+        q = std::make_pair(node(rng), node(rng));
+    }
+    std::vector<TLcaIndex::TId> answers;
+    double batch = measure_seconds([&] { index->LcaBatch(queries, answers); });
+
+    std::cout << "tree size:" << index->Size()
+        << " tarjan offline (all " << ctx.results.size() << " pairs):" << tarjan << "s"
+        << " index build:" << build << "s"
+        << " batch of " << queries_count << " queries:" << batch << "s"
+        << " queries/s:" << queries_count / batch
+        << (same ? "" : " MISMATCH") << std::endl;
+
+    destroy_tree(root);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        benchmark_lca(std::stoul(argv[1]), std::stoul(argv[2]));
+        return 0;
+    }
+
     const std::vector<int> values = {4, 5, 1, 2, 5, 3, 10};
     TTreeNodePtr root = nullptr;
     for (int v : values) {
@@ -242,8 +437,10 @@ int main() {
     LCAContext ctx;
     LCA(root, ctx);
 
-    for (const auto& [index, lca] : ctx.results) {
-        std::cout << "Node: " << index.first->key << ", " << index.second->key << " LCA:" << lca->key << std::endl; 
+    TLcaIndex index(root);
+    for (const auto& [pair, lca] : ctx.results) {
+        std::cout << "Node: " << pair.first->key << ", " << pair.second->key << " LCA:" << lca->key
+            << " index LCA:" << index.Lca(pair.first, pair.second)->key << std::endl; 
     }
 
     destroy_tree(root);
@@ -0,0 +1,457 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <barrier>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <sys/resource.h>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TAdjacencyList = std::vector<TVertextId>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v, .Adj = {}});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2) {
+        Edges.emplace_back(v1, v2);
+        Vertices[v1].Adj.push_back(v2);
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(v1);
+        }
+    }
+};
+
+using TGraph = TGraphGeneric<true>;
+
+struct TComponentIds {
+    // Component of every vertex. Components are numbered in reverse topological order:
+    // an edge between two components always goes from a larger id to a smaller one.
+    std::vector<std::uint32_t> Component;
+    std::uint32_t Count = 0;
+};
+
+// One pass, non recursive SCC (Pearce's variant of Tarjan), see strongly_connected.
+// Component ids are counted down from n-1 as components complete, then flipped.
+TComponentIds TarjanComponentIds(const TGraph& input) {
+    const std::size_t n = input.Vertices.size();
+    std::vector<std::uint32_t> rindex(n, 0);
+    std::vector<bool> root(n, false);
+    struct TFrame {
+        std::uint32_t vertex;
+        std::uint32_t edge;
+    };
+    std::vector<TFrame> callStack;
+    std::vector<std::uint32_t> tarjanStack;
+    std::uint32_t index = 1;
+    std::size_t count = 0;
+
+    auto open = [&](std::uint32_t v) {
+        rindex[v] = index++;
+        root[v] = true;
+        callStack.push_back(TFrame{.vertex = v, .edge = 0});
+    };
+
+    for (std::uint32_t start = 0; start < n; ++start) {
+        if (rindex[start] != 0) {
+            continue;
+        }
+        open(start);
+        while (!callStack.empty()) {
+            auto& frame = callStack.back();
+            auto v = frame.vertex;
+            const auto& adj = input.Vertices[v].Adj;
+            if (frame.edge < adj.size()) {
+                auto w = adj[frame.edge++];
+                if (rindex[w] == 0) {
+                    open(w);
+                } else if (rindex[w] < rindex[v]) {
+                    rindex[v] = rindex[w];
+                    root[v] = false;
+                }
+                continue;
+            }
+            // All edges of v are explored
+            callStack.pop_back();
+            if (root[v]) {
+                --index;
+                while (!tarjanStack.empty() && rindex[v] <= rindex[tarjanStack.back()]) {
+                    rindex[tarjanStack.back()] = n - 1 - count;
+                    tarjanStack.pop_back();
+                    --index;
+                }
+                rindex[v] = n - 1 - count++;
+            } else {
+                tarjanStack.push_back(v);
+            }
+            if (!callStack.empty()) {
+                auto parent = callStack.back().vertex;
+                if (rindex[v] < rindex[parent]) {
+                    rindex[parent] = rindex[v];
+                    root[parent] = false;
+                }
+            }
+        }
+    }
+    for (auto& r : rindex) {
+        r = n - 1 - r;
+    }
+    return TComponentIds{.Component = std::move(rindex), .Count = static_cast<std::uint32_t>(count)};
+}
+
+// dst |= src over 64-bit words. Widest ISA available at compile time (-march=native),
+// plain words otherwise (the compiler is still free to auto-vectorize it).
+struct TSimd {
+#if defined(__AVX512F__)
+    static constexpr std::size_t Words = 8;
+    static void Or(std::uint64_t* dst, const std::uint64_t* src) {
+        _mm512_storeu_si512(dst, _mm512_or_si512(_mm512_loadu_si512(dst), _mm512_loadu_si512(src)));
+    }
+#elif defined(__AVX2__)
+    static constexpr std::size_t Words = 4;
+    static void Or(std::uint64_t* dst, const std::uint64_t* src) {
+        auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+        auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_or_si256(d, s));
+    }
+#else
+    static constexpr std::size_t Words = 1;
+    static void Or(std::uint64_t* dst, const std::uint64_t* src) {
+        *dst |= *src;
+    }
+#endif
+};
+
+// Rows are padded to this many words, so the OR loop has no tail for any ISA
+constexpr std::size_t ROW_ALIGN_WORDS = 8;
+static_assert(ROW_ALIGN_WORDS % TSimd::Words == 0);
+
+void OrRow(std::uint64_t* dst, const std::uint64_t* src, std::size_t words) {
+    for (std::size_t w = 0; w < words; w += TSimd::Words) {
+        TSimd::Or(dst + w, src + w);
+    }
+}
+
+// Runs body(begin, end, thread) over the items of every level, split between threads, with a
+// barrier between levels. nextLevel runs on one thread at the barrier and returns the size of
+// the next level, 0 to stop.
+template<typename TBody, typename TNextLevel>
+void ForEachLevel(std::size_t firstLevelSize, std::size_t threadsCount, TBody&& body, TNextLevel&& nextLevel) {
+    std::size_t levelSize = firstLevelSize;
+    auto onCompletion = [&]() noexcept {
+        levelSize = nextLevel();
+    };
+    std::barrier sync(threadsCount, onCompletion);
+    auto worker = [&](std::size_t t) {
+        while (levelSize != 0) {
+            body(levelSize * t / threadsCount, levelSize * (t + 1) / threadsCount, t);
+            sync.arrive_and_wait();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < threadsCount; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// All-pairs reachability. Strongly connected components are condensed first, every vertex of a
+// component reaches the same set. Component ids are a reverse topological order, so component c
+// reaches only ids <= c and its row is a triangular bitset of c + 1 bits. Rows are built from
+// sinks up: row(c) = {c} | OR of rows of its successors.
+//
+// Components whose successors are all done form a level, rows of one level are independent and
+// split between threads. Successors are merged by decreasing id: when bit s is already set, row s
+// is already included through a larger successor and is skipped, which on dependency graphs
+// leaves a few ORs per row.
+class TTransitiveClosure {
+public:
+    explicit TTransitiveClosure(const TGraph& graph, std::size_t threadsCount = std::thread::hardware_concurrency()) {
+        if (graph.Vertices.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("Graph is too big for 32 bit ids");
+        }
+        auto ids = TarjanComponentIds(graph);
+        Component = std::move(ids.Component);
+        Build(graph, ids.Count, std::max<std::size_t>(1, threadsCount));
+    }
+
+    bool Reachable(TGraph::TVertextId u, TGraph::TVertextId v) const {
+        const std::uint32_t from = Component[u];
+        const std::uint32_t to = Component[v];
+        return to <= from && (Bits[RowOffsets[from] + to / 64] >> (to % 64) & 1);
+    }
+
+    std::size_t ComponentsCount() const {
+        return RowOffsets.empty() ? 0 : RowOffsets.size() - 1;
+    }
+
+    std::size_t MemoryBytes() const {
+        return Component.capacity() * sizeof(std::uint32_t)
+            + (RowOffsets.capacity() + Bits.capacity()) * sizeof(std::uint64_t);
+    }
+
+private:
+    static std::size_t RowWords(std::uint32_t c) {
+        return (c / 64 + ROW_ALIGN_WORDS) / ROW_ALIGN_WORDS * ROW_ALIGN_WORDS;
+    }
+
+    void Build(const TGraph& graph, std::uint32_t count, std::size_t threadsCount) {
+        // Condensation as CSR, rows by decreasing target without duplicates
+        std::vector<std::uint32_t> offsets(count + 1, 0);
+        for (const auto& e : graph.Edges) {
+            if (Component[e.v1] != Component[e.v2]) {
+                ++offsets[Component[e.v1] + 1];
+            }
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> targets(offsets.back());
+        {
+            std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (const auto& e : graph.Edges) {
+                auto c1 = Component[e.v1];
+                auto c2 = Component[e.v2];
+                if (c1 != c2) {
+                    targets[fill[c1]++] = c2;
+                }
+            }
+        }
+        std::uint32_t kept = 0;
+        for (std::uint32_t c = 0; c < count; ++c) {
+            auto begin = targets.begin() + offsets[c];
+            auto end = targets.begin() + offsets[c + 1];
+            std::sort(begin, end, std::greater<>());
+            end = std::unique(begin, end);
+            offsets[c] = kept;
+            kept = std::copy(begin, end, targets.begin() + kept) - targets.begin();
+        }
+        offsets[count] = kept;
+        targets.resize(kept);
+
+        // Level of a component is its height above the sinks, successors have smaller ids
+        std::vector<std::uint32_t> level(count, 0);
+        std::uint32_t levelsCount = count > 0 ? 1 : 0;
+        for (std::uint32_t c = 0; c < count; ++c) {
+            for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+                level[c] = std::max(level[c], level[targets[i]] + 1);
+            }
+            levelsCount = std::max(levelsCount, level[c] + 1);
+        }
+        std::vector<std::uint32_t> levelOffsets(levelsCount + 1, 0);
+        for (auto l : level) {
+            ++levelOffsets[l + 1];
+        }
+        std::partial_sum(levelOffsets.begin(), levelOffsets.end(), levelOffsets.begin());
+        std::vector<std::uint32_t> order(count);
+        {
+            std::vector<std::uint32_t> fill(levelOffsets.begin(), levelOffsets.end() - 1);
+            for (std::uint32_t c = 0; c < count; ++c) {
+                order[fill[level[c]]++] = c;
+            }
+        }
+
+        RowOffsets.resize(count + 1);
+        RowOffsets[0] = 0;
+        for (std::uint32_t c = 0; c < count; ++c) {
+            RowOffsets[c + 1] = RowOffsets[c] + RowWords(c);
+        }
+        Bits.assign(RowOffsets.back(), 0);
+        if (count == 0) {
+            return;
+        }
+
+        std::size_t current = 0;
+        ForEachLevel(levelOffsets[1], threadsCount, [&](std::size_t begin, std::size_t end, std::size_t) {
+            const std::size_t first = levelOffsets[current];
+            for (std::size_t i = first + begin; i < first + end; ++i) {
+                const std::uint32_t c = order[i];
+                std::uint64_t* row = Bits.data() + RowOffsets[c];
+                row[c / 64] |= std::uint64_t(1) << (c % 64);
+                for (auto j = offsets[c]; j < offsets[c + 1]; ++j) {
+                    const std::uint32_t s = targets[j];
+                    if (row[s / 64] >> (s % 64) & 1) {
+                        continue;
+                    }
+                    OrRow(row, Bits.data() + RowOffsets[s], RowWords(s));
+                }
+            }
+        }, [&]() {
+            ++current;
+            return current < levelsCount ? levelOffsets[current + 1] - levelOffsets[current] : 0;
+        });
+    }
+
+    std::vector<std::uint32_t> Component;
+    // Row of component c is Bits[RowOffsets[c] .. RowOffsets[c + 1]), bit t is "c reaches t"
+    std::vector<std::uint64_t> RowOffsets;
+    std::vector<std::uint64_t> Bits;
+};
+
+long PeakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Dependency like graph: every vertex depends on a few others with smaller ids, mostly nearby
+// ones, and a few short edges point the other way and close small cycles
+TGraph MakeDependencyGraph(std::size_t vertexesCount, std::size_t edgesCount, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    TGraph graph;
+    graph.Vertices.resize(vertexesCount);
+    graph.Edges.reserve(edgesCount);
+    while (graph.Edges.size() < edgesCount && vertexesCount > 1) {
+        std::size_t v = 1 + rng() % (vertexesCount - 1);
+        std::size_t distance = 1 + rng() % (rng() % 8 == 0 ? v : std::min<std::size_t>(v, 1000));
+        std::size_t u = v - distance;
+        if (distance < 16 && rng() % 1000 == 0) {
+            std::swap(u, v);
+        }
+        graph.AddEdge(v, u);
+    }
+    return graph;
+}
+
+// Usage: ./a.out <vertexes> <edges> [threads], e.g. ./a.out 100000 500000
+void Benchmark(std::size_t vertexesCount, std::size_t edgesCount, std::size_t threadsCount) {
+    auto graph = MakeDependencyGraph(vertexesCount, edgesCount, 42);
+    std::mt19937_64 rng(7);
+
+    std::optional<TTransitiveClosure> closure;
+    double buildTime = MeasureSeconds([&] { closure.emplace(graph, threadsCount); });
+
+    // BFS from every vertex is estimated from a sample, which also checks the closure
+    constexpr std::size_t SAMPLE = 200;
+    std::size_t reachablePairs = 0;
+    bool ok = true;
+    std::vector<bool> seen;
+    std::vector<TGraph::TVertextId> queue;
+    double bfsTime = 0;
+    for (std::size_t i = 0; i < SAMPLE; ++i) {
+        const auto source = rng() % vertexesCount;
+        bfsTime += MeasureSeconds([&] {
+            seen.assign(vertexesCount, false);
+            queue.assign(1, source);
+            seen[source] = true;
+            for (std::size_t head = 0; head < queue.size(); ++head) {
+                for (auto v : graph.Vertices[queue[head]].Adj) {
+                    if (!seen[v]) {
+                        seen[v] = true;
+                        queue.push_back(v);
+                    }
+                }
+            }
+        });
+        reachablePairs += queue.size();
+        for (TGraph::TVertextId v = 0; v < vertexesCount; ++v) {
+            ok &= closure->Reachable(source, v) == seen[v];
+        }
+    }
+
+    constexpr std::size_t QUERIES = 10'000'000;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> queries(QUERIES);
+    for (auto& q : queries) {
+        q = {rng() % vertexesCount, rng() % vertexesCount};
+    }
+    std::size_t positive = 0;
+    double queryTime = MeasureSeconds([&] {
+        for (const auto& [u, v] : queries) {
+            positive += closure->Reachable(u, v);
+        }
+    });
+
+    std::cout << "vertexes:" << vertexesCount << " edges:" << graph.Edges.size()
+        << " components:" << closure->ComponentsCount()
+        << " reachable from a vertex (avg):" << reachablePairs / SAMPLE << std::endl
+        << "  closure build: " << buildTime << "s threads:" << threadsCount
+        << " memory:" << closure->MemoryBytes() / 1024 << "KB"
+        << " (dense n x n bits: " << vertexesCount * vertexesCount / 8 / 1024 << "KB)" << std::endl
+        << "  bfs from every vertex (estimated): " << bfsTime / SAMPLE * vertexesCount << "s"
+        << " speedup:" << bfsTime / SAMPLE * vertexesCount / buildTime << std::endl
+        << "  queries: " << QUERIES / queryTime / 1e6 << "M/s positive:" << positive
+        << (ok ? "" : " MISMATCH") << std::endl
+        << "  peak rss: " << PeakRssKb() / 1024 << "MB" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        Benchmark(std::stoul(argv[1]), std::stoul(argv[2]), argc > 3 ? std::stoul(argv[3]) : std::thread::hardware_concurrency());
+        return 0;
+    }
+
+    TGraph graph;
+    auto a = graph.AddVertex("a");
+    auto b = graph.AddVertex("b");
+    auto c = graph.AddVertex("c");
+    auto d = graph.AddVertex("d");
+    auto e = graph.AddVertex("e");
+    auto f = graph.AddVertex("f");
+
+    graph.AddEdge(a, b);
+    graph.AddEdge(b, c);
+    graph.AddEdge(c, a);
+    graph.AddEdge(c, d);
+    graph.AddEdge(e, d);
+    graph.AddEdge(d, f);
+
+    TTransitiveClosure closure(graph);
+    std::cout << "  ";
+    for (const auto& v : graph.Vertices) {
+        std::cout << v.Value << " ";
+    }
+    std::cout << std::endl;
+    for (TGraph::TVertextId u = 0; u < graph.Vertices.size(); ++u) {
+        std::cout << graph.Vertices[u].Value << " ";
+        for (TGraph::TVertextId v = 0; v < graph.Vertices.size(); ++v) {
+            std::cout << closure.Reachable(u, v) << " ";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <cstdint>
+
+#include "vertex_reordering.h"
+
+template<bool Directed>
+struct TGraphGeneric {
+
+    // Ready to be a template parameter
+    using TVertexValue = std::string;
+
+    using TVertextId = std::size_t;
+    using TEdgeId = std::size_t;
+
+    struct TVertextPath {
+        TVertextId vertex = 0;
+        TEdgeId edge = 0;
+    };
+    using TAdjacencyList = std::vector<TVertextPath>;
+    struct TVertex {
+        TVertexValue Value;
+        TAdjacencyList Adj;
+    };
+
+    using TVertices = std::vector<TVertex>;
+
+    struct TEdge {
+        TVertextId v1;
+        TVertextId v2;
+        int weight;
+    };
+    using TEdges = std::vector<TEdge>;
+    
+    TVertices Vertices;
+    TEdges Edges;
+
+    
+    TVertextId AddVertex(const TVertexValue& v) {
+        TVertextId id = Vertices.size();
+        Vertices.emplace_back(TVertex{.Value = v});
+        return id;
+    }
+
+    void AddEdge(TVertextId v1, TVertextId v2, int weight) {
+        auto edgeId = Edges.size();
+        Edges.emplace_back(v1, v2, weight);
+        Vertices[v1].Adj.push_back(TVertextPath{.vertex = v2, .edge=edgeId});
+        // Add back ref for undirected graph
+        if (!Directed) {
+            Vertices[v2].Adj.push_back(TVertextPath{.vertex = v1, .edge=edgeId});
+        }
+    }
+
+    void AddEdge(const TEdge& edge) {
+        AddEdge(edge.v1, edge.v2, edge.weight);
+    }
+};
+
+
+using TGraph = TGraphGeneric<true>;
+
+// ---------------- Algorithms to compare, written against plain TGraph ids
+
+std::vector<int> BFSDistances(const TGraph& graph, TGraph::TVertextId start) {
+    std::vector<int> distance(graph.Vertices.size(), -1);
+    std::vector<TGraph::TVertextId> queue{start};
+    distance[start] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        auto current = queue[head];
+        for (const auto& adj : graph.Vertices[current].Adj) {
+            if (distance[adj.vertex] < 0) {
+                distance[adj.vertex] = distance[current] + 1;
+                queue.push_back(adj.vertex);
+            }
+        }
+    }
+    return distance;
+}
+
+constexpr int INF_WEIGHT = std::numeric_limits<int>::max() / 2;
+
+struct TVertexInfo {
+    TGraph::TVertextId vertex = 0;
+    int weight = 0;
+
+    bool operator<(const TVertexInfo& r) const {
+        return weight > r.weight;
+    }
+};
+
+std::vector<int> Dijkstra(const TGraph& graph, TGraph::TVertextId start) {
+    std::vector<int> distance(graph.Vertices.size(), INF_WEIGHT);
+    std::priority_queue<TVertexInfo> pq;
+    distance[start] = 0;
+    pq.push(TVertexInfo{.vertex = start, .weight = 0});
+    while (!pq.empty()) {
+        auto [v, weight] = pq.top();
+        pq.pop();
+        if (weight != distance[v]) {
+            // stale entry
+            continue;
+        }
+        for (const auto& adj : graph.Vertices[v].Adj) {
+            auto candidate = weight + graph.Edges[adj.edge].weight;
+            if (candidate < distance[adj.vertex]) {
+                distance[adj.vertex] = candidate;
+                pq.push(TVertexInfo{.vertex = adj.vertex, .weight = candidate});
+            }
+        }
+    }
+    return distance;
+}
+
+// Pearce's iterative Tarjan, returns component id of every vertex
+std::vector<std::uint32_t> StronglyConnectedComponents(const TGraph& input, std::size_t& count) {
+    const std::size_t n = input.Vertices.size();
+    std::vector<std::uint32_t> rindex(n, 0);
+    std::vector<bool> root(n, false);
+    struct TFrame {
+        TGraph::TVertextId vertex;
+        std::size_t edge;
+    };
+    std::vector<TFrame> callStack;
+    std::vector<TGraph::TVertextId> tarjanStack;
+    std::uint32_t index = 1;
+    count = 0;
+
+    auto open = [&](TGraph::TVertextId v) {
+        rindex[v] = index++;
+        root[v] = true;
+        callStack.push_back(TFrame{.vertex = v, .edge = 0});
+    };
+
+    for (TGraph::TVertextId start = 0; start < n; ++start) {
+        if (rindex[start] != 0) {
+            continue;
+        }
+        open(start);
+        while (!callStack.empty()) {
+            auto& frame = callStack.back();
+            auto v = frame.vertex;
+            const auto& adj = input.Vertices[v].Adj;
+            if (frame.edge < adj.size()) {
+                auto w = adj[frame.edge++].vertex;
+                if (rindex[w] == 0) {
+                    open(w);
+                } else if (rindex[w] < rindex[v]) {
+                    rindex[v] = rindex[w];
+                    root[v] = false;
+                }
+                continue;
+            }
+            callStack.pop_back();
+            if (root[v]) {
+                --index;
+                while (!tarjanStack.empty() && rindex[v] <= rindex[tarjanStack.back()]) {
+                    rindex[tarjanStack.back()] = n - 1 - count;
+                    tarjanStack.pop_back();
+                    --index;
+                }
+                rindex[v] = n - 1 - count++;
+            } else {
+                tarjanStack.push_back(v);
+            }
+            if (!callStack.empty()) {
+                auto parent = callStack.back().vertex;
+                if (rindex[v] < rindex[parent]) {
+                    rindex[parent] = rindex[v];
+                    root[parent] = false;
+                }
+            }
+        }
+    }
+    return rindex;
+}
+
+// ---------------- Benchmark
+
+// Vertex ids are shuffled to model arbitrary AddVertex order
+TGraph ShuffledGraph(std::size_t n, const std::vector<TGraph::TEdge>& edges, std::mt19937_64& rng) {
+    std::vector<std::size_t> id(n);
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), rng);
+    TGraph graph;
+    graph.Vertices.reserve(n);
+    graph.Edges.reserve(edges.size());
+    for (std::size_t v = 0; v < n; ++v) {
+        graph.AddVertex(std::to_string(v));
+    }
+    for (const auto& edge : edges) {
+        graph.AddEdge(id[edge.v1], id[edge.v2], edge.weight);
+    }
+    return graph;
+}
+
+// Road network like: side x side grid with edges in both directions
+TGraph MakeGridGraph(std::size_t side, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<TGraph::TEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            std::size_t v = r * side + c;
+            if (c + 1 < side) {
+                int weight = 1 + rng() % 100;
+                edges.push_back({v, v + 1, weight});
+                edges.push_back({v + 1, v, weight});
+            }
+            if (r + 1 < side) {
+                int weight = 1 + rng() % 100;
+                edges.push_back({v, v + side, weight});
+                edges.push_back({v + side, v, weight});
+            }
+        }
+    }
+    return ShuffledGraph(side * side, edges, rng);
+}
+
+TGraph MakeRmatGraph(std::size_t scale, std::size_t edgesCount, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dice(0, 1);
+    std::vector<TGraph::TEdge> edges;
+    edges.reserve(edgesCount);
+    for (std::size_t e = 0; e < edgesCount; ++e) {
+        std::size_t v1 = 0;
+        std::size_t v2 = 0;
+        for (std::size_t bit = 0; bit < scale; ++bit) {
+            double r = dice(rng);
+            v1 = v1 * 2 + (r >= 0.76);
+            v2 = v2 * 2 + (r >= 0.57 && r < 0.76) + (r >= 0.95);
+        }
+        edges.push_back({v1, v2, static_cast<int>(1 + rng() % 100)});
+    }
+    return ShuffledGraph(std::size_t(1) << scale, edges, rng);
+}
+
+template<typename TFunc>
+double MeasureSeconds(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct TRunResult {
+    std::vector<int> Bfs;
+    std::vector<int> Dijkstra;
+    std::size_t ComponentsCount = 0;
+};
+
+TRunResult Run(const std::string& name, const TGraph& graph, TGraph::TVertextId source) {
+    TRunResult result;
+    double bfs = MeasureSeconds([&] { result.Bfs = BFSDistances(graph, source); });
+    double dijkstra = MeasureSeconds([&] { result.Dijkstra = Dijkstra(graph, source); });
+    double scc = MeasureSeconds([&] { StronglyConnectedComponents(graph, result.ComponentsCount); });
+    std::cout << "    " << name << " bfs: " << bfs << "s dijkstra: " << dijkstra << "s scc: " << scc << "s";
+    return result;
+}
+
+// Usage: ./a.out grid <side>
+//        ./a.out rmat <scale> <edges>
+void Benchmark(const TGraph& graph) {
+    std::cout << "vertexes:" << graph.Vertices.size() << " edges:" << graph.Edges.size() << std::endl;
+    const TGraph::TVertextId source = 0;
+    auto expected = Run("original", graph, source);
+    std::cout << std::endl;
+
+    const std::pair<EVertexOrder, const char*> orders[] = {
+        {EVertexOrder::Degree, "degree"},
+        {EVertexOrder::ReverseCuthillMcKee, "rcm"},
+        {EVertexOrder::Bfs, "bfs order"},
+    };
+    for (auto [order, name] : orders) {
+        TGraph relabeled;
+        TVertexPermutation permutation;
+        double relabel = MeasureSeconds([&] {
+            permutation = ComputeOrder(graph, order);
+            relabeled = Relabel(graph, permutation);
+        });
+        auto result = Run(name, relabeled, permutation.NewId[source]);
+        bool same = permutation.ToOld(result.Bfs) == expected.Bfs
+            && permutation.ToOld(result.Dijkstra) == expected.Dijkstra
+            && result.ComponentsCount == expected.ComponentsCount;
+        std::cout << " relabel: " << relabel << "s" << (same ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "grid") {
+        Benchmark(MakeGridGraph(std::stoul(argv[2]), 42));
+        return 0;
+    }
+    if (argc > 3 && std::string(argv[1]) == "rmat") {
+        Benchmark(MakeRmatGraph(std::stoul(argv[2]), std::stoul(argv[3]), 42));
+        return 0;
+    }
+
+    // Path a - b - c - d - e added in scattered order
+    TGraph graph;
+    auto c = graph.AddVertex("c");
+    auto a = graph.AddVertex("a");
+    auto e = graph.AddVertex("e");
+    auto b = graph.AddVertex("b");
+    auto d = graph.AddVertex("d");
+    for (auto [v1, v2] : {std::pair{a, b}, {b, c}, {c, d}, {d, e}}) {
+        graph.AddEdge(v1, v2, 1);
+        graph.AddEdge(v2, v1, 1);
+    }
+    auto permutation = ComputeOrder(graph, EVertexOrder::ReverseCuthillMcKee);
+    auto relabeled = Relabel(graph, permutation);
+    for (TGraph::TVertextId v = 0; v < relabeled.Vertices.size(); ++v) {
+        std::cout << v << ": " << relabeled.Vertices[v].Value << " (was " << permutation.OldId[v] << ")" << std::endl;
+    }
+    auto distances = permutation.ToOld(BFSDistances(relabeled, permutation.NewId[a]));
+    std::cout << "hops from a to e: " << distances[e] << std::endl;
+    return 0;
+}
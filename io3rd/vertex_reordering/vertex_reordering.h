@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+
+// Vertex relabeling for traversal locality. Ids from AddVertex follow insertion order, so
+// neighbours are usually far apart in Vertices and in every per vertex attribute array.
+// ComputeOrder picks a new order, Relabel rebuilds the graph in it:
+//
+//   Degree                - by adjacency size, largest first: hubs share a few cache lines
+//   ReverseCuthillMcKee   - BFS from a low degree vertex, neighbours by increasing degree,
+//                           reversed; keeps ids of neighbours close (small bandwidth)
+//   Bfs                   - plain BFS discovery order
+//
+// Traversals follow Vertices[v].Adj, so for directed graphs the orders use out edges only.
+enum class EVertexOrder {
+    Degree,
+    ReverseCuthillMcKee,
+    Bfs,
+};
+
+struct TVertexPermutation {
+    // Old id -> new id and back
+    std::vector<std::uint32_t> NewId;
+    std::vector<std::uint32_t> OldId;
+    // Same for edges, filled by Relabel: edges are renumbered in the new adjacency order
+    std::vector<std::uint32_t> NewEdgeId;
+    std::vector<std::uint32_t> OldEdgeId;
+
+    // Attribute array indexed by old ids -> indexed by new ids
+    template<typename T>
+    std::vector<T> ToNew(const std::vector<T>& byOld) const {
+        std::vector<T> byNew(byOld.size());
+        for (std::size_t v = 0; v < byOld.size(); ++v) {
+            byNew[NewId[v]] = byOld[v];
+        }
+        return byNew;
+    }
+
+    // Results computed on the relabeled graph -> indexed by old ids
+    template<typename T>
+    std::vector<T> ToOld(const std::vector<T>& byNew) const {
+        std::vector<T> byOld(byNew.size());
+        for (std::size_t v = 0; v < byNew.size(); ++v) {
+            byOld[OldId[v]] = byNew[v];
+        }
+        return byOld;
+    }
+};
+
+namespace NVertexOrder {
+
+template<typename TAdj>
+std::uint32_t Target(const TAdj& adj) {
+    if constexpr (requires { adj.vertex; }) {
+        return adj.vertex;
+    } else {
+        return adj;
+    }
+}
+
+// Vertices by adjacency size with counting sort, stable in id
+template<typename TGraph>
+std::vector<std::uint32_t> ByDegree(const TGraph& graph, bool descending) {
+    const std::size_t n = graph.Vertices.size();
+    std::size_t maxDegree = 0;
+    for (const auto& vertex : graph.Vertices) {
+        maxDegree = std::max(maxDegree, vertex.Adj.size());
+    }
+    std::vector<std::uint32_t> start(maxDegree + 2, 0);
+    for (const auto& vertex : graph.Vertices) {
+        auto degree = vertex.Adj.size();
+        ++start[(descending ? maxDegree - degree : degree) + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<std::uint32_t> order(n);
+    for (std::uint32_t v = 0; v < n; ++v) {
+        auto degree = graph.Vertices[v].Adj.size();
+        order[start[descending ? maxDegree - degree : degree]++] = v;
+    }
+    return order;
+}
+
+// BFS forest, every tree rooted at the first not yet visited vertex of starts.
+// With sortByDegree neighbours of every vertex are queued by increasing degree (Cuthill-McKee).
+template<typename TGraph>
+std::vector<std::uint32_t> BfsForest(const TGraph& graph, const std::vector<std::uint32_t>& starts, bool sortByDegree) {
+    const std::size_t n = graph.Vertices.size();
+    std::vector<bool> visited(n, false);
+    std::vector<std::uint32_t> order;
+    order.reserve(n);
+    for (auto start : starts) {
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = true;
+        order.push_back(start);
+        for (std::size_t head = order.size() - 1; head < order.size(); ++head) {
+            const std::size_t firstNew = order.size();
+            for (const auto& adj : graph.Vertices[order[head]].Adj) {
+                auto v = Target(adj);
+                if (!visited[v]) {
+                    visited[v] = true;
+                    order.push_back(v);
+                }
+            }
+            if (sortByDegree) {
+                std::stable_sort(order.begin() + firstNew, order.end(), [&graph](auto l, auto r) {
+                    return graph.Vertices[l].Adj.size() < graph.Vertices[r].Adj.size();
+                });
+            }
+        }
+    }
+    return order;
+}
+
+} // namespace NVertexOrder
+
+// Permutation only, the graph is not touched. Edge ids are left empty.
+template<typename TGraph>
+TVertexPermutation ComputeOrder(const TGraph& graph, EVertexOrder kind) {
+    using namespace NVertexOrder;
+    const std::size_t n = graph.Vertices.size();
+    TVertexPermutation permutation;
+    switch (kind) {
+        case EVertexOrder::Degree:
+            permutation.OldId = ByDegree(graph, true);
+            break;
+        case EVertexOrder::ReverseCuthillMcKee:
+            // Peripheral vertices have low degree, so every component starts at its lowest one
+            permutation.OldId = BfsForest(graph, ByDegree(graph, false), true);
+            std::reverse(permutation.OldId.begin(), permutation.OldId.end());
+            break;
+        case EVertexOrder::Bfs: {
+            std::vector<std::uint32_t> starts(n);
+            std::iota(starts.begin(), starts.end(), 0);
+            permutation.OldId = BfsForest(graph, starts, false);
+            break;
+        }
+    }
+    permutation.NewId.resize(n);
+    for (std::uint32_t v = 0; v < n; ++v) {
+        permutation.NewId[permutation.OldId[v]] = v;
+    }
+    return permutation;
+}
+
+// Builds the graph in the new order: vertex values move with their vertex, adjacency lists are
+// sorted by new target id and edges are renumbered in adjacency order of their first endpoint,
+// so Edges[adj.edge] is read almost sequentially. Fills the edge mapping of permutation.
+template<typename TGraph>
+TGraph Relabel(const TGraph& graph, TVertexPermutation& permutation) {
+    using namespace NVertexOrder;
+    const std::size_t n = graph.Vertices.size();
+    constexpr std::uint32_t NO_EDGE = UINT32_MAX;
+    permutation.NewEdgeId.assign(graph.Edges.size(), NO_EDGE);
+    permutation.OldEdgeId.clear();
+    permutation.OldEdgeId.reserve(graph.Edges.size());
+
+    TGraph result;
+    if constexpr (requires { result.Reserve(n, graph.Edges.size()); }) {
+        result.Reserve(n, graph.Edges.size());
+    } else {
+        result.Vertices.reserve(n);
+    }
+    for (std::uint32_t newId = 0; newId < n; ++newId) {
+        const auto oldId = permutation.OldId[newId];
+        const auto& vertex = graph.Vertices[oldId];
+        // TVertex::Value in the io3rd copies, the payload column in graph_generic.h
+        if constexpr (requires { graph.Value(oldId); }) {
+            result.AddVertex(graph.Value(oldId));
+        } else {
+            result.AddVertex(vertex.Value);
+        }
+        auto& target = result.Vertices.back();
+        target.Adj = vertex.Adj;
+        for (auto& adj : target.Adj) {
+            if constexpr (requires { adj.vertex; }) {
+                adj.vertex = permutation.NewId[adj.vertex];
+            } else {
+                adj = permutation.NewId[adj];
+            }
+        }
+        std::sort(target.Adj.begin(), target.Adj.end(), [](const auto& l, const auto& r) {
+            return Target(l) < Target(r);
+        });
+        if constexpr (requires { target.Adj.front().edge; }) {
+            for (auto& adj : target.Adj) {
+                auto& edgeId = permutation.NewEdgeId[adj.edge];
+                if (edgeId == NO_EDGE) {
+                    edgeId = permutation.OldEdgeId.size();
+                    permutation.OldEdgeId.push_back(adj.edge);
+                }
+                adj.edge = edgeId;
+            }
+        }
+    }
+    // Edges nobody points to (no adjacency entries) keep their relative order at the end
+    for (std::uint32_t e = 0; e < graph.Edges.size(); ++e) {
+        if (permutation.NewEdgeId[e] == NO_EDGE) {
+            permutation.NewEdgeId[e] = permutation.OldEdgeId.size();
+            permutation.OldEdgeId.push_back(e);
+        }
+    }
+    result.Edges.reserve(graph.Edges.size());
+    for (auto old : permutation.OldEdgeId) {
+        auto edge = graph.Edges[old];
+        edge.v1 = permutation.NewId[edge.v1];
+        edge.v2 = permutation.NewId[edge.v2];
+        result.Edges.push_back(edge);
+    }
+    return result;
+}